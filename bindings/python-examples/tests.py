@@ -213,6 +213,67 @@ class BParseOptionsTestCase(unittest.TestCase):
         po = ParseOptions(spell_guess=False)
         self.assertEqual(po.spell_guess, 0)
 
+    def test_setting_share_connector_tails(self):
+        po = ParseOptions()
+        po.share_connector_tails = True
+        self.assertEqual(clg.parse_options_get_share_connector_tails(po._obj), True)
+        po.share_connector_tails = False
+        self.assertEqual(clg.parse_options_get_share_connector_tails(po._obj), False)
+
+    def test_setting_share_connector_tails_to_non_boolean_raises_type_error(self):
+        po = ParseOptions()
+        self.assertRaises(TypeError, setattr, po, "share_connector_tails", "a")
+
+    def test_setting_sat_eager_constraints(self):
+        po = ParseOptions()
+        po.sat_eager_constraints = True
+        self.assertEqual(clg.parse_options_get_sat_eager_constraints(po._obj), True)
+        po.sat_eager_constraints = False
+        self.assertEqual(clg.parse_options_get_sat_eager_constraints(po._obj), False)
+
+    def test_setting_sat_eager_constraints_to_non_boolean_raises_type_error(self):
+        po = ParseOptions()
+        self.assertRaises(TypeError, setattr, po, "sat_eager_constraints", "a")
+
+    def test_setting_disjunct_budget(self):
+        po = ParseOptions()
+        self.assertEqual(po.disjunct_budget, 0)
+        po.disjunct_budget = 100
+        self.assertEqual(clg.parse_options_get_disjunct_budget(po._obj), 100)
+        po = ParseOptions(disjunct_budget=5)
+        self.assertEqual(po.disjunct_budget, 5)
+
+    def test_setting_disjunct_budget_to_invalid_values_raises_error(self):
+        po = ParseOptions()
+        self.assertRaises(TypeError, setattr, po, "disjunct_budget", "a")
+        self.assertRaises(ValueError, setattr, po, "disjunct_budget", -1)
+
+    def test_setting_threads(self):
+        po = ParseOptions()
+        self.assertEqual(po.threads, 1)
+        po.threads = 4
+        self.assertEqual(clg.parse_options_get_threads(po._obj), 4)
+        po = ParseOptions(threads=2)
+        self.assertEqual(po.threads, 2)
+
+    def test_setting_threads_to_invalid_values_raises_error(self):
+        po = ParseOptions()
+        self.assertRaises(TypeError, setattr, po, "threads", "a")
+        self.assertRaises(ValueError, setattr, po, "threads", 0)
+
+    def test_setting_result_cache(self):
+        po = ParseOptions()
+        self.assertEqual(po.result_cache, 0)
+        po.result_cache = 1024
+        self.assertEqual(clg.parse_options_get_result_cache(po._obj), 1024)
+        po = ParseOptions(result_cache=10)
+        self.assertEqual(po.result_cache, 10)
+
+    def test_setting_result_cache_to_invalid_values_raises_error(self):
+        po = ParseOptions()
+        self.assertRaises(TypeError, setattr, po, "result_cache", "a")
+        self.assertRaises(ValueError, setattr, po, "result_cache", -1)
+
     def test_specifying_parse_options(self):
         po = ParseOptions(linkage_limit=99)
         self.assertEqual(clg.parse_options_get_linkage_limit(po._obj), 99)
@@ -842,6 +903,163 @@ class ZENConstituentsCase(unittest.TestCase):
         self.assertEqual(linkages[0].constituent_tree(),
                 "(S (NP this.p)\n   (VP is.v\n       (NP a test.n))\n   .)\n")
 
+class ZENEquivalentOptionsTestCase(unittest.TestCase):
+    """
+    Parse options that are intended to change only the parsing speed or
+    memory usage must not change the parse results.
+    """
+    sentences = [
+        'The man who the dog that the cat chased bit went to the store '
+        'yesterday to buy some milk and eggs.',
+        'I saw the man with the telescope on the hill in the park near the river.',
+        'about people attended the meeting that was held in the large hall',
+        'this is a test of the the emergency broadcast system',
+    ]
+
+    # Shorter sentences for the SAT parser, most of them with null words.
+    sat_sentences = [
+        'about people attended the meeting that was held in the large hall',
+        'this is a test of the the emergency broadcast system',
+        'this this is is a a test',
+        'the the dog dog ran ran to the house',
+    ]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.d = Dictionary(lang='en')
+
+    @classmethod
+    def tearDownClass(cls):
+        del cls.d
+
+    def parses(self, sentences=None, dictionary=None, reparse=False,
+               **options):
+        """
+        Return the null count and the costs and diagrams of all the linkages
+        of each of the test sentences, for the given parse options.
+        If reparse is True, each sentence is first parsed without null
+        links, and then parsed again.
+        """
+        po = ParseOptions(linkage_limit=10000, max_null_count=999, **options)
+        result = []
+        for text in sentences or self.sentences:
+            sent = Sentence(text, dictionary or self.d, po)
+            if reparse:
+                po.max_null_count = 0
+                sent.parse()
+                po.max_null_count = 999
+            linkages = sent.parse()
+            result.append((sent.null_count(), sorted(
+                (l.unused_word_cost(), l.disjunct_cost(), l.link_cost(),
+                 l.diagram()) for l in linkages)))
+        return result
+
+    def assertSameParses(self, **options):
+        self.maxDiff = None
+        self.assertEqual(self.parses(**options), self.parses())
+
+    def test_share_connector_tails(self):
+        linkage_testfile(self, self.d, ParseOptions(share_connector_tails=True))
+        self.assertSameParses(share_connector_tails=True)
+
+    def test_lazy_loading(self):
+        clg.dictionary_set_lazy_loading(True)
+        try:
+            self.assertTrue(clg.dictionary_get_lazy_loading())
+            lazy_dict = Dictionary(lang='en')
+        finally:
+            clg.dictionary_set_lazy_loading(False)
+        self.assertFalse(clg.dictionary_get_lazy_loading())
+        linkage_testfile(self, lazy_dict, ParseOptions())
+        self.maxDiff = None
+        self.assertEqual(self.parses(dictionary=lazy_dict), self.parses())
+
+    def test_disjunct_budget(self):
+        """
+        A disjunct budget which trims no word doesn't change the results.
+        A small one may drop linkages, but the budget is widened until
+        the sentence has its least null count.
+        """
+        self.maxDiff = None
+        all_parses = self.parses()
+        self.assertEqual(self.parses(disjunct_budget=1000000), all_parses)
+        self.assertEqual([nc for nc, _ in self.parses(disjunct_budget=2)],
+                         [nc for nc, _ in all_parses])
+
+    def test_threads(self):
+        self.maxDiff = None
+        self.assertEqual(self.parses(threads=4), self.parses())
+        # Sentences with null words, whose null counts are counted
+        # concurrently.
+        self.assertEqual(self.parses(self.sat_sentences, threads=4),
+                         self.parses(self.sat_sentences))
+
+    def test_result_cache(self):
+        """
+        The results of sentences which are parsed again (also with
+        different whitespace) are copied from the cache, and they are the
+        same as those of parsing them.
+        """
+        self.maxDiff = None
+        all_parses = self.parses()
+        self.assertEqual(self.parses(result_cache=4096), all_parses)
+        self.assertEqual(self.parses([' ' + s.replace(' ', '  ')
+                                      for s in self.sentences],
+                                     result_cache=4096), all_parses)
+
+    def test_shared_expressions(self):
+        clg.dictionary_set_shared_expressions(True)
+        try:
+            self.assertTrue(clg.dictionary_get_shared_expressions())
+            shared_dict = Dictionary(lang='en')
+        finally:
+            clg.dictionary_set_shared_expressions(False)
+        self.assertFalse(clg.dictionary_get_shared_expressions())
+        linkage_testfile(self, shared_dict, ParseOptions())
+        self.maxDiff = None
+        self.assertEqual(self.parses(dictionary=shared_dict), self.parses())
+
+    def test_loading_threads(self):
+        clg.dictionary_set_loading_threads(4)
+        try:
+            self.assertEqual(clg.dictionary_get_loading_threads(), 4)
+            threads_dict = Dictionary(lang='en')
+        finally:
+            clg.dictionary_set_loading_threads(1)
+        self.assertEqual(clg.dictionary_get_loading_threads(), 1)
+        linkage_testfile(self, threads_dict, ParseOptions())
+        self.maxDiff = None
+        self.assertEqual(self.parses(dictionary=threads_dict), self.parses())
+
+    def skip_if_no_sat(self):
+        if ParseOptions(use_sat=True).use_sat != True:
+            raise unittest.SkipTest("Library not configured with SAT parser")
+
+    def test_sat_eager_constraints(self):
+        self.skip_if_no_sat()
+        linkage_testfile(self, self.d,
+                         ParseOptions(use_sat=True, sat_eager_constraints=True),
+                         'sat')
+        self.maxDiff = None
+        self.assertEqual(
+            self.parses(self.sat_sentences, use_sat=True,
+                        sat_eager_constraints=True),
+            self.parses(self.sat_sentences, use_sat=True))
+
+    def test_sat_null_count(self):
+        """
+        The SAT parser finds the same null counts as the classic parser,
+        and reusing its solver for a reparse doesn't change the results.
+        """
+        self.skip_if_no_sat()
+        sat = self.parses(self.sat_sentences, use_sat=True)
+        self.assertEqual([nc for nc, _ in sat],
+                         [nc for nc, _ in self.parses(self.sat_sentences)])
+        self.assertEqual([nc for nc, _ in sat], [0, 1, 2, 1])
+        self.maxDiff = None
+        self.assertEqual(
+            self.parses(self.sat_sentences, reparse=True, use_sat=True), sat)
+
 class ZDELangTestCase(unittest.TestCase):
     @classmethod
     def setUpClass(cls):
@@ -40,7 +40,12 @@ class ParseOptions(object):
                  spell_guess=False,
                  use_sat=False,
                  max_parse_time=-1,
-                 disjunct_cost=2.7):
+                 disjunct_cost=2.7,
+                 share_connector_tails=False,
+                 sat_eager_constraints=False,
+                 disjunct_budget=0,
+                 threads=1,
+                 result_cache=0):
 
         self._obj = clg.parse_options_create()
         self.verbosity = verbosity
@@ -55,6 +60,11 @@ class ParseOptions(object):
         self.use_sat = use_sat
         self.max_parse_time = max_parse_time
         self.disjunct_cost = disjunct_cost
+        self.share_connector_tails = share_connector_tails
+        self.sat_eager_constraints = sat_eager_constraints
+        self.disjunct_budget = disjunct_budget
+        self.threads = threads
+        self.result_cache = result_cache
 
     # Allow only the attribute names listed below.
     def __setattr__(self, name, value):
@@ -274,6 +284,91 @@ class ParseOptions(object):
             raise TypeError("all_short_connectors must be set to a bool")
         clg.parse_options_set_all_short_connectors(self._obj, 1 if value else 0)
 
+    @property
+    def share_connector_tails(self):
+        """
+         If true, then after pruning, identical trailing connector sequences
+         of the disjuncts of each word are shared, so the parser computes
+         identical sub-problems only once. The results are not changed.
+        """
+        return clg.parse_options_get_share_connector_tails(self._obj)
+
+    @share_connector_tails.setter
+    def share_connector_tails(self, value):
+        if not isinstance(value, bool):
+            raise TypeError("share_connector_tails must be set to a bool")
+        clg.parse_options_set_share_connector_tails(self._obj, value)
+
+    @property
+    def sat_eager_constraints(self):
+        """
+         If true, the SAT parser encodes the linkage connectivity and the
+         consistency of the morphology alternatives in advance, instead of
+         rejecting the solutions that violate them one by one after solving.
+         The results are not changed.
+        """
+        return clg.parse_options_get_sat_eager_constraints(self._obj)
+
+    @sat_eager_constraints.setter
+    def sat_eager_constraints(self, value):
+        if not isinstance(value, bool):
+            raise TypeError("sat_eager_constraints must be set to a bool")
+        clg.parse_options_set_sat_eager_constraints(self._obj, value)
+
+    @property
+    def disjunct_budget(self):
+        """
+         If not 0, the classic parser uses at most about this number of the
+         lowest-cost disjuncts of each word. If the sentence then has no
+         complete linkage, the budget is doubled until no word is trimmed.
+         The default is 0, i.e. no limit.
+        """
+        return clg.parse_options_get_disjunct_budget(self._obj)
+
+    @disjunct_budget.setter
+    def disjunct_budget(self, value):
+        if not isinstance(value, int):
+            raise TypeError("disjunct_budget must be set to an integer")
+        if value < 0:
+            raise ValueError("disjunct_budget must not be negative")
+        clg.parse_options_set_disjunct_budget(self._obj, value)
+
+    @property
+    def threads(self):
+        """
+         The maximum number of threads that may be used to parse a sentence
+         (including the calling one). The results are not changed.
+         The default is 1, i.e. no additional threads.
+        """
+        return clg.parse_options_get_threads(self._obj)
+
+    @threads.setter
+    def threads(self, value):
+        if not isinstance(value, int):
+            raise TypeError("threads must be set to an integer")
+        if value < 1:
+            raise ValueError("threads must be at least 1")
+        clg.parse_options_set_threads(self._obj, value)
+
+    @property
+    def result_cache(self):
+        """
+         If not 0, the parse results of the sentences are kept in a cache
+         of their dictionary, which uses up to about this number of
+         kilobytes. A sentence which is parsed again with the same parse
+         options gets a copy of its cached results. The default is 0,
+         i.e. no caching.
+        """
+        return clg.parse_options_get_result_cache(self._obj)
+
+    @result_cache.setter
+    def result_cache(self, value):
+        if not isinstance(value, int):
+            raise TypeError("result_cache must be set to an integer")
+        if value < 0:
+            raise ValueError("result_cache must not be negative")
+        clg.parse_options_set_result_cache(self._obj, value)
+
 
 class LG_Error(Exception):
     @staticmethod
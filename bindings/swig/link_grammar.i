@@ -44,6 +44,12 @@ void dictionary_delete(Dictionary dict);
 void dictionary_set_data_dir(const char * path);
 %newobject dictionary_get_data_dir;
 char * dictionary_get_data_dir(void);
+void dictionary_set_lazy_loading(bool);
+bool dictionary_get_lazy_loading(void);
+void dictionary_set_shared_expressions(bool);
+bool dictionary_get_shared_expressions(void);
+void dictionary_set_loading_threads(int);
+int dictionary_get_loading_threads(void);
 
 /**********************************************************************
 *
@@ -85,6 +91,16 @@ int  parse_options_get_all_short_connectors(Parse_Options opts);
 void parse_options_reset_resources(Parse_Options opts);
 void parse_options_set_use_sat_parser(Parse_Options opts, bool val);
 int parse_options_get_use_sat_parser(Parse_Options opts);
+void parse_options_set_share_connector_tails(Parse_Options opts, bool val);
+bool parse_options_get_share_connector_tails(Parse_Options opts);
+void parse_options_set_sat_eager_constraints(Parse_Options opts, bool val);
+bool parse_options_get_sat_eager_constraints(Parse_Options opts);
+void parse_options_set_disjunct_budget(Parse_Options opts, int budget);
+int parse_options_get_disjunct_budget(Parse_Options opts);
+void parse_options_set_threads(Parse_Options opts, int threads);
+int parse_options_get_threads(Parse_Options opts);
+void parse_options_set_result_cache(Parse_Options opts, int kbytes);
+int parse_options_get_result_cache(Parse_Options opts);
 
 /**********************************************************************
 *
@@ -79,12 +79,14 @@ struct Parse_Options_s
 
 	/* Choice of the parser to use */
 	bool use_sat_solver;   /* Use the Boolean SAT based parser */
+	bool sat_eager_constraints; /* SAT: Encode connectivity in advance */
 #ifdef USE_VITERBI
 	bool use_viterbi;      /* Use the Viterbi decoder-based parser */
 #endif
 
 	/* Options governing the parser internals operation */
 	double disjunct_cost;  /* Max disjunct cost to allow */
+	int disjunct_budget;   /* Max disjuncts per word (0 for no limit) */
 	short min_null_count;  /* The minimum number of null links to allow */
 	short max_null_count;  /* The maximum number of null links to allow */
 	bool islands_ok;       /* If TRUE, then linkages with islands
@@ -95,6 +97,9 @@ struct Parse_Options_s
 	                          no longer than this.  Default = 16 */
 	bool all_short;        /* If true, there can be no connectors that are exempt */
 	bool repeatable_rand;  /* Reset rand number gen after every parse. */
+	bool share_connector_tails; /* Share identical connector sequences */
+	int threads;           /* Max number of parsing threads. Default = 1 */
+	int result_cache;      /* Parse result cache size in KB (0: no cache) */
 
 	/* Options governing post-processing */
 	bool perform_pp_prune; /* Perform post-processing-based pruning TRUE */
@@ -122,10 +127,12 @@ struct Sentence_s
 	String_set *   string_set;  /* Used for assorted strings */
 	Pool_desc * fm_Match_node;  /* Fast-matcher Match_node memory pool */
 	Pool_desc * Table_connector_pool; /* Count memoizing memory pool */
+	link_name_memo *link_name_memo; /* Link names by connector pair */
 
 	/* Wordgraph stuff. FIXME: create stand-alone struct for these. */
 	Gword *wordgraph;            /* Tokenization wordgraph */
 	Gword *last_word;            /* FIXME Last issued word */
+	Pool_desc *Gword_pool;       /* Wordgraph words memory pool */
 	word_queue_t *word_queue;    /* Element in queue of words to tokenize */
 	word_queue_t *word_queue_last;
 	size_t gword_node_num;       /* Debug - for differentiating between
@@ -154,7 +161,8 @@ struct Sentence_s
 #ifdef USE_SAT_SOLVER
 	void *hook;                 /* Hook for the SAT solver */
 #endif /* USE_SAT_SOLVER */
-	void *disjuncts_connectors_memblock;
+	void *disjuncts_connectors_memblock; /* All the sentence disjuncts */
+	size_t disjuncts_connectors_memblock_sz;
 };
 
 #endif
@@ -34,6 +34,7 @@ typedef struct String_set_s String_set;
 typedef struct Word_struct Word;
 typedef struct Gword_struct Gword;
 typedef struct gword_set gword_set;
+typedef struct link_name_memo_s link_name_memo;
 
 /* Post-processing structures */
 typedef struct pp_knowledge_s pp_knowledge;
@@ -15,12 +15,15 @@
 
 #include "api-structures.h"
 #include "corpus/corpus.h"
+#include "dict-common/dict-common.h" // for dictionary_ref
 #include "dict-common/dict-utils.h" // for free_X_nodes
 #include "disjunct-utils.h"  // for free_disjuncts
+#include "linkage/analyze-linkage.h" // for free_link_name_memo
 #include "linkage/linkage.h"
 #include "memory-pool.h"
 #include "parse/histogram.h"  // for PARSE_NUM_OVERFLOW
 #include "parse/parse.h"
+#include "parse/parse-cache.h"
 #include "post-process/post-process.h" // for post_process_new()
 #include "prepare/exprune.h"
 #include "string-set.h"
@@ -115,10 +118,12 @@ Parse_Options parse_options_create(void)
 	 * (and should probably not be a parse option).
 	 */
 	po->disjunct_cost = 2.7;
+	po->disjunct_budget = 0;
 	po->min_null_count = 0;
 	po->max_null_count = 0;
 	po->islands_ok = false;
 	po->use_sat_solver = false;
+	po->sat_eager_constraints = false;
 #ifdef USE_VITERBI
 	po->use_viterbi = false;
 #endif
@@ -145,6 +150,9 @@ Parse_Options parse_options_create(void)
 	po->perform_pp_prune = true;
 	po->twopass_length = 30;
 	po->repeatable_rand = true;
+	po->share_connector_tails = false;
+	po->threads = 1;
+	po->result_cache = 0;
 	po->resources = resources_create();
 	po->use_cluster_disjuncts = false;
 	po->display_morphology = false;
@@ -294,6 +302,20 @@ bool parse_options_get_use_sat_parser(Parse_Options opts) {
 	return opts->use_sat_solver;
 }
 
+/**
+ * If set, the SAT parser encodes the linkage connectivity and the
+ * consistency of the tokenization alternatives as clauses, instead of
+ * rejecting the solutions that violate them one by one after solving.
+ * This mostly pays off on long sentences.
+ */
+void parse_options_set_sat_eager_constraints(Parse_Options opts, bool val) {
+	opts->sat_eager_constraints = val;
+}
+
+bool parse_options_get_sat_eager_constraints(Parse_Options opts) {
+	return opts->sat_eager_constraints;
+}
+
 #ifdef USE_VITERBI
 void parse_options_set_use_viterbi(Parse_Options opts, bool dummy) {
 	opts->use_viterbi = dummy;
@@ -322,6 +344,22 @@ double parse_options_get_disjunct_cost(Parse_Options opts)
 	return opts->disjunct_cost;
 }
 
+/**
+ * If not 0, the classic parser builds at most about this number of the
+ * lowest-cost disjuncts for each word. If the sentence then has no
+ * complete linkage, the budget is doubled until no word is trimmed.
+ * The default is 0, i.e. no limit.
+ */
+void parse_options_set_disjunct_budget(Parse_Options opts, int budget)
+{
+	opts->disjunct_budget = MAX(budget, 0);
+}
+
+int parse_options_get_disjunct_budget(Parse_Options opts)
+{
+	return opts->disjunct_budget;
+}
+
 void parse_options_set_min_null_count(Parse_Options opts, int val) {
 	opts->min_null_count = val;
 }
@@ -391,6 +429,53 @@ bool parse_options_get_repeatable_rand(Parse_Options opts) {
 	return opts->repeatable_rand;
 }
 
+/**
+ * If true, identical trailing connector sequences of the disjuncts of
+ * each word are shared after pruning, so the parser memoizes their
+ * sub-problems only once. This doesn't change the parse results.
+ */
+void parse_options_set_share_connector_tails(Parse_Options opts, bool val) {
+	opts->share_connector_tails = val;
+}
+
+bool parse_options_get_share_connector_tails(Parse_Options opts) {
+	return opts->share_connector_tails;
+}
+
+/**
+ * The maximum number of threads that may be used to parse a sentence.
+ * Currently, the disjuncts of the sentence words are built and
+ * deduplicated by up to this number of threads, and when a sentence
+ * has no complete linkage, up to this number of null counts are tried
+ * concurrently. The default is 1, i.e. no additional threads. It has
+ * no effect if the library has been built without thread support.
+ */
+void parse_options_set_threads(Parse_Options opts, int threads) {
+	opts->threads = MAX(threads, 1);
+}
+
+int parse_options_get_threads(Parse_Options opts) {
+	return opts->threads;
+}
+
+/**
+ * If not 0, the parse results of the sentences are kept in a cache of
+ * their dictionary, which uses up to about this number of kilobytes.
+ * A sentence which has the same text (up to whitespace) and the same
+ * parse options as a cached one gets a copy of its results, instead of
+ * being parsed again. The least recently used results are evicted when
+ * the cache is full. The default is 0, i.e. no caching.
+ */
+void parse_options_set_result_cache(Parse_Options opts, int kbytes)
+{
+	opts->result_cache = MAX(kbytes, 0);
+}
+
+int parse_options_get_result_cache(Parse_Options opts)
+{
+	return opts->result_cache;
+}
+
 void parse_options_set_max_parse_time(Parse_Options opts, int dummy) {
 	opts->resources->max_parse_time = dummy;
 }
@@ -453,6 +538,7 @@ Sentence sentence_create(const char *input_string, Dictionary dict)
 	memset(sent, 0, sizeof(struct Sentence_s));
 
 	sent->dict = dict;
+	dictionary_ref(dict);
 	sent->string_set = string_set_create();
 	sent->rand_state = global_rand_state;
 	sent->disjuncts_connectors_memblock = NULL;
@@ -537,9 +623,13 @@ void sentence_delete(Sentence sent)
 	global_rand_state = sent->rand_state;
 	pool_delete(sent->fm_Match_node);
 	pool_delete(sent->Table_connector_pool);
+	free_link_name_memo(sent);
 	if (IS_DB_DICT(sent->dict))
 		condesc_reuse(sent->dict);
 
+	/* This frees the dictionary if dictionary_delete() has already been
+	 * called for it. */
+	dictionary_delete(sent->dict);
 	free(sent);
 }
 
@@ -602,6 +692,26 @@ int sentence_link_cost(Sentence sent, LinkageIdx i)
 	return sent->lnkages[i].lifo.link_cost;
 }
 
+/**
+ * Get the statistics of the memory pools of the given sentence. Their
+ * element high-water marks are of all the parses of the sentence so far.
+ * Up to n entries are stored in stats (which may be NULL if n is 0).
+ * Return the number of pools, which may be more than n.
+ */
+size_t sentence_get_pool_stats(Sentence sent, lg_pool_stats *stats, size_t n)
+{
+	if (!sent) return 0;
+
+	Pool_desc *const pools[] =
+	{
+		sent->Gword_pool,
+		sent->fm_Match_node,
+		sent->Table_connector_pool,
+	};
+
+	return pool_list_get_stats(pools, ARRAY_SIZE(pools), stats, n);
+}
+
 int sentence_parse(Sentence sent, Parse_Options opts)
 {
 	int rc;
@@ -636,6 +746,12 @@ int sentence_parse(Sentence sent, Parse_Options opts)
 
 	resources_reset(opts->resources);
 
+	if (!opts->use_sat_solver && parse_cache_lookup(sent, opts))
+	{
+		print_time(opts, "Found in the parse result cache");
+		return sent->num_valid_linkages;
+	}
+
 	/* When the SQL dict is used, expressions are read on demand, so
 	 * the connector descriptor table is not yet ready at this point. */
 	if (IS_DB_DICT(sent->dict))
@@ -653,6 +769,8 @@ int sentence_parse(Sentence sent, Parse_Options opts)
 	else
 	{
 		classic_parse(sent, opts);
+		if (!resources_exhausted(opts->resources))
+			parse_cache_insert(sent, opts);
 	}
 	print_time(opts, "Finished parse");
 
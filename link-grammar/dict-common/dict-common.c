@@ -16,7 +16,10 @@
 #include "dict-api.h"
 #include "dict-common.h"
 #include "dict-defines.h"
+#include "exp-share.h"
 #include "file-utils.h"
+#include "parse/parse-cache.h"     // for parse_cache_delete
+#include "parse/prune.h"           // for pp_prune_table_delete
 #include "post-process/pp_knowledge.h" // Needed only for pp_close !!??
 #include "regex-morph.h"
 #include "string-set.h"
@@ -101,6 +104,31 @@ const char * dictionary_get_lang(Dictionary dict)
 	return dict->lang;
 }
 
+/**
+ * Get the statistics of the memory pools of the given dictionary.
+ * Up to n entries are stored in stats (which may be NULL if n is 0).
+ * Return the number of pools, which may be more than n.
+ *
+ * The statistics of a dictionary that is used concurrently by other
+ * threads (e.g. for lazy loading) are only approximate.
+ */
+size_t dictionary_get_pool_stats(Dictionary dict, lg_pool_stats *stats,
+                                 size_t n)
+{
+	if (!dict) return 0;
+
+	Pool_desc *const pools[] =
+	{
+		dict->exp_list.Exp_pool,
+		dict->exp_list.E_list_pool,
+		dict->Dict_node_pool,
+		dict->Unparsed_exp_pool,
+		dict->contable.mempool,
+	};
+
+	return pool_list_get_stats(pools, ARRAY_SIZE(pools), stats, n);
+}
+
 /* ======================================================================== */
 /* Dictionary lookup stuff */
 
@@ -242,48 +270,34 @@ int delete_dictionary_words(Dictionary dict, const char * s)
 #endif /* USEFUL_BUT_NOT_CURRENTLY_USED */
 
 /**
- * The following two functions free the Exp s and the
- * E_lists of the dictionary.  Not to be confused with
- * free_E_list in word-utils.c.
+ * Free the Exp s and the E_lists of the dictionary.  Not to be
+ * confused with free_E_list in word-utils.c.
  */
-static void free_Elist(E_list * l)
-{
-	E_list * l1;
-
-	for (; l != NULL; l = l1) {
-		l1 = l->next;
-		free(l);
-	}
-}
-
 void free_Exp_list(Exp_list * eli)
 {
-	Exp * e1;
-	Exp * e = eli->exp_list;
-	for (; e != NULL; e = e1)
-	{
-		e1 = e->next;
-		if (e->type != CONNECTOR_type)
-		{
-		   free_Elist(e->u.l);
-		}
-		free(e);
-	}
-}
-
-static void free_dict_node_recursive(Dict_node * dn)
-{
-	if (dn == NULL) return;
-	free_dict_node_recursive(dn->left);
-	free_dict_node_recursive(dn->right);
-	free(dn);
+	pool_delete(eli->Exp_pool);
+	pool_delete(eli->E_list_pool);
+	eli->Exp_pool = NULL;
+	eli->E_list_pool = NULL;
 }
 
 static void free_dictionary(Dictionary dict)
 {
-	free_dict_node_recursive(dict->root);
+	pool_delete(dict->Dict_node_pool);
 	free_Word_file(dict->word_file_header);
 	free_Exp_list(&dict->exp_list);
+	free_shared_expressions(dict);
+
+	if (dict->lazy_exps)
+	{
+		for (Lazy_file *lf = dict->lazy_files, *next; NULL != lf; lf = next)
+		{
+			next = lf->next;
+			fclose(lf->fp);
+			free(lf);
+		}
+		pool_delete(dict->Unparsed_exp_pool);
+	}
 }
 
 static void affix_list_delete(Dictionary dict)
@@ -298,9 +312,94 @@ static void affix_list_delete(Dictionary dict)
 	dict->afdict_class = NULL;
 }
 
+/* ======================================================================== */
+/* Dictionary reference counting.
+ *
+ * Each sentence holds a reference to its dictionary, so
+ * dictionary_delete() may be called while sentences which use the
+ * dictionary still exist; the dictionary is then freed by the
+ * sentence_delete() of the last one of them.
+ *
+ * A Dictionary_handle publishes the current dictionary of a long-running
+ * program (e.g. a parse server), and allows replacing it (e.g. after the
+ * dictionary files have been edited) while parsing continues in other
+ * threads: Sentences created after dictionary_handle_set() use the new
+ * dictionary, while the existing ones continue to use the old one. */
+
+struct Dictionary_handle_s
+{
+	Dictionary dict;
+	long lock;              /* Protects the dictionary pointer. */
+};
+
+/**
+ * Take a reference to the dictionary. It is released by
+ * dictionary_delete().
+ */
+void dictionary_ref(Dictionary dict)
+{
+	refcount_inc(&dict->refcount);
+}
+
+/**
+ * Create a handle for the given dictionary.
+ * The handle takes over the caller's reference to the dictionary.
+ */
+Dictionary_handle dictionary_handle_create(Dictionary dict)
+{
+	Dictionary_handle dh = malloc(sizeof(struct Dictionary_handle_s));
+
+	dh->dict = dict;
+	dh->lock = 0;
+	return dh;
+}
+
+/**
+ * Return the current dictionary of the handle, with a reference that
+ * the caller should release by dictionary_delete() when it is done
+ * with it. Sentences take their own reference, so the caller may
+ * release it right after sentence_create().
+ */
+Dictionary dictionary_handle_get(Dictionary_handle dh)
+{
+	spin_lock(&dh->lock);
+	Dictionary dict = dh->dict;
+	if (NULL != dict) dictionary_ref(dict);
+	spin_unlock(&dh->lock);
+
+	return dict;
+}
+
+/**
+ * Publish a new dictionary in the handle (which takes over the caller's
+ * reference to it), and release the previous one. The previous one is
+ * freed when the last sentence that uses it is deleted.
+ */
+void dictionary_handle_set(Dictionary_handle dh, Dictionary dict)
+{
+	spin_lock(&dh->lock);
+	Dictionary old_dict = dh->dict;
+	dh->dict = dict;
+	spin_unlock(&dh->lock);
+
+	dictionary_delete(old_dict);
+}
+
+void dictionary_handle_delete(Dictionary_handle dh)
+{
+	if (NULL == dh) return;
+	dictionary_delete(dh->dict);
+	free(dh);
+}
+
+/**
+ * Release a reference to the dictionary, and free it if this was the
+ * last one.
+ */
 void dictionary_delete(Dictionary dict)
 {
 	if (!dict) return;
+	if (0 <= refcount_dec(&dict->refcount)) return;
 
 	if (verbosity > 0) {
 		prt_error("Info: Freeing dictionary %s\n", dict->name);
@@ -320,9 +419,11 @@ void dictionary_delete(Dictionary dict)
 	}
 
 	condesc_delete(dict);
+	parse_cache_delete(dict);
 
 	if (dict->close) dict->close(dict);
 
+	pp_prune_table_delete(dict);
 	pp_knowledge_close(dict->base_knowledge);
 	pp_knowledge_close(dict->hpsg_knowledge);
 	string_set_delete(dict->string_set);
@@ -17,6 +17,7 @@
 #include "api-types.h"                  // pp_knowledge
 #include "connectors.h"                 // ConTable
 #include "dict-structures.h"
+#include "memory-pool.h"
 #include "utilities.h"                  // locale_t
 
 #define EMPTY_CONNECTOR "ZZZ"
@@ -27,13 +28,50 @@
 typedef struct Afdict_class_struct Afdict_class;
 typedef struct Exp_list_s Exp_list;
 typedef struct Regex_node_s Regex_node;
+typedef struct Unparsed_exp_s Unparsed_exp;
+typedef struct Lazy_file_s Lazy_file;
 
-/* Used for memory management */
+/* Used for memory management: The Exp and E_list structs are allocated
+ * from these pools (created on first use), and freed all together. */
 struct Exp_list_s
 {
-	Exp * exp_list;
+	Pool_desc * Exp_pool;
+	Pool_desc * E_list_pool;
 };
 
+/* In lazy loading mode, the expressions of most dictionary entries
+ * are not parsed when the dictionary is read. Instead, they get an
+ * Exp of UNPARSED_type, which holds the position of the expression
+ * text in its dictionary file. It is read and parsed on the first
+ * lookup of one of its words, and then overwritten in place with the
+ * parsed expression. The dictionary files are kept open for that. */
+#define UNPARSED_type ((Exp_type)0)
+
+struct Lazy_file_s
+{
+	Lazy_file * next;          /* For closing */
+	FILE * fp;
+	const char * name;         /* For error messages */
+};
+
+struct Unparsed_exp_s
+{
+	Lazy_file * file;
+	long offset;               /* Of the expression text in the file */
+	unsigned int length;       /* Of the text, including its ';' */
+	int line_number;           /* For error messages */
+	bool being_parsed;         /* For detecting circular references */
+};
+
+/* A file that is referred to by the dictionary file (a word file or an
+ * included dictionary), which has been read in advance. */
+typedef struct
+{
+	const char * name;         /* Its path, as given to get_file_contents() */
+	char * contents;           /* NULL if it cannot be read, or taken */
+	bool is_dict;              /* An included dictionary (else a word file) */
+} Prefetched_file;
+
 typedef struct X_node_struct X_node;
 struct X_node_struct
 {
@@ -83,6 +121,7 @@ struct Dictionary_s
 	const char * locale;    /* Locale name */
 	locale_t     lctype;    /* Locale argument for the *_l() functions */
 	int          num_entries;
+	long         refcount;  /* References in addition to the creator's */
 
 	bool         use_unknown_word;
 	bool         unknown_word_defined;
@@ -115,16 +154,40 @@ struct Dictionary_s
 
 	pp_knowledge  * base_knowledge;    /* Core post-processing rules */
 	pp_knowledge  * hpsg_knowledge;    /* Head-Phrase Structure rules */
+	struct pp_prune_table_s * pp_prune_table; /* See parse/prune.c */
 	Connector_set * unlimited_connector_set; /* NULL=everything is unlimited */
 	String_set *    string_set;        /* Set of link names in the dictionary */
 	Word_file *     word_file_header;
+	Pool_desc *     Dict_node_pool;    /* The nodes of the word tree */
+	Prefetched_file * prefetched;      /* Only while the dictionary is read */
+	size_t          num_prefetched;
 	ConTable        contable;
 
-	/* exp_list links together all the Exp structs that are allocated
-	 * in reading this dictionary.  Needed for freeing the dictionary
+	/* All the Exp structs (and their E_lists) that are allocated in
+	 * reading this dictionary.  Needed for freeing the dictionary.
 	 */
 	Exp_list        exp_list;
 
+	/* The chunks of shared expression nodes and of their E_list cells,
+	 * when the expressions are shared (see exp-share.c). */
+	Exp          ** exp_chunks;
+	E_list       ** exp_cell_chunks;
+	size_t          num_exp_chunks;
+	size_t          num_exp_nodes;
+	size_t          num_exp_cells;
+	struct exp_share_s * exp_share; /* Only while the dictionary is read */
+
+	/* Cached parse results (see parse/parse-cache.c). */
+	struct parse_cache_s * parse_cache;
+	long            parse_cache_lock;  /* A spinlock; see utilities.h */
+
+	/* Lazy expression parsing; see UNPARSED_type above. */
+	bool            lazy_exps;
+	long            exp_lock;          /* A spinlock serializing the parsing */
+	Pool_desc     * Unparsed_exp_pool;
+	Lazy_file     * lazy_files;
+	Lazy_file     * lazy_file;         /* Of the text being read, or NULL */
+
 	/* Private data elements that come in play only while the
 	 * dictionary is being read, and are not otherwise used.
 	 */
@@ -143,8 +206,11 @@ struct Dictionary_s
  * probably don't need these. */
 
 bool find_word_in_dict(const Dictionary dict, const char *);
+void dictionary_ref(Dictionary);
 
 Exp * Exp_create(Exp_list *);
+E_list * E_list_create(Exp_list *);
+Dict_node * Dict_node_create(Dictionary);
 void add_empty_word(Dictionary const, X_node *);
 void free_Exp_list(Exp_list *);
 
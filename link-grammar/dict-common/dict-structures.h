@@ -45,13 +45,14 @@ typedef enum
  */
 struct Exp_struct
 {
-	Exp * next;    /* Used only for memory management, for freeing */
+	Exp * next;    /* Unused (the Exp s are freed with their memory pool) */
 	Exp_type type; /* One of three types: AND, OR, or connector. */
 	char dir;      /* The connector connects to: '-': the left; '+': the right */
 	bool multi;    /* TRUE if a multi-connector (for connector)  */
 	union {
 		E_list * l;           /* Only needed for non-terminals */
 		condesc_t * condesc;  /* Only needed if it's a connector */
+		struct Unparsed_exp_s * unparsed; /* Internal (lazy loading) */
 	} u;
 	double cost;   /* The cost of using this expression.
 	                  Only used for non-terminals */
@@ -0,0 +1,372 @@
+/*************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                      */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+
+#include "connectors.h"
+#include "dict-common.h"
+#include "exp-share.h"
+#include "utilities.h"
+
+/*
+ * Sharing of identical dictionary expressions (hash-consing).
+ *
+ * The dictionary reader builds a separate tree for each entry, so the
+ * dictionary holds many structurally identical sub-expressions (the
+ * same connectors, and the same combinations of them with the same
+ * costs). In the expression sharing mode (see
+ * dictionary_set_shared_expressions()), the expression of each entry is
+ * replaced by canonical nodes as soon as it has been read, and its
+ * original nodes are freed (by rewinding the exp_list pools), so their
+ * memory is reused when the next entries are read. Identical
+ * sub-expressions become the same node, and the expressions of the
+ * dictionary become a DAG.
+ *
+ * The canonical nodes and their E_list cells are allocated in chunks
+ * that are freed with the dictionary. The position of a canonical node
+ * in the chunks is its id (see exp_node_id()).
+ *
+ * The expressions are not shared in lazy loading mode, since a lazily
+ * parsed expression may be referred to by the entry being read.
+ */
+
+typedef struct
+{
+	Exp *e;
+	unsigned int hash;
+} shared_node;
+
+struct exp_share_s
+{
+	shared_node *table;     /* The canonical nodes, by their structure */
+	size_t table_size;      /* A power of 2 */
+	size_t num_nodes;       /* Original nodes, for the memory report */
+	size_t num_cells;       /* Original E_list cells */
+	Pool_mark Exp_mark;     /* The exp_list pools at the start of the entry */
+	Pool_mark E_list_mark;
+};
+
+static unsigned int mix_hash(uint64_t h)
+{
+	h = (h ^ (h >> 31)) * 0x7fb5d329728ea185ULL;
+	return (unsigned int)(h ^ (h >> 27));
+}
+
+static unsigned int node_hash(const Exp *e, Exp * const *child, size_t n)
+{
+	uint64_t cost;
+	memcpy(&cost, &e->cost, sizeof(cost));
+
+	uint64_t h = e->type;
+	h = h * 31 + cost;
+	if (CONNECTOR_type == e->type)
+	{
+		h = h * 31 + (unsigned char)e->dir;
+		h = h * 31 + e->multi;
+		h = h * 31 + mix_hash((uintptr_t)e->u.condesc);
+	}
+	else
+	{
+		for (size_t i = 0; i < n; i++)
+			h = h * 31 + mix_hash((uintptr_t)child[i]);
+	}
+
+	return mix_hash(h);
+}
+
+/**
+ * Return true if the canonical node s is identical to e, whose
+ * children have the canonical nodes child[0..n-1].
+ */
+static bool node_equal(const Exp *s, const Exp *e, Exp * const *child,
+                       size_t n)
+{
+	if (s->type != e->type) return false;
+	if (0 != memcmp(&s->cost, &e->cost, sizeof(e->cost))) return false;
+
+	if (CONNECTOR_type == e->type)
+	{
+		return (s->dir == e->dir) && (s->multi == e->multi) &&
+		       (s->u.condesc == e->u.condesc);
+	}
+
+	size_t i = 0;
+	for (E_list *l = s->u.l; NULL != l; l = l->next, i++)
+		if ((i == n) || (l->e != child[i])) return false;
+	return (i == n);
+}
+
+static void table_grow(struct exp_share_s *es)
+{
+	shared_node *old_table = es->table;
+	size_t old_size = es->table_size;
+
+	es->table_size = (0 == old_size) ? 4096 : 2 * old_size;
+	es->table = malloc(es->table_size * sizeof(shared_node));
+	memset(es->table, 0, es->table_size * sizeof(shared_node));
+
+	for (size_t i = 0; i < old_size; i++)
+	{
+		if (NULL == old_table[i].e) continue;
+
+		size_t h = old_table[i].hash & (es->table_size - 1);
+		while (NULL != es->table[h].e) h = (h + 1) & (es->table_size - 1);
+		es->table[h] = old_table[i];
+	}
+	free(old_table);
+}
+
+static Exp *shared_node_new(Dictionary dict)
+{
+	size_t n = dict->num_exp_nodes++;
+
+	if (0 == n % EXP_CHUNK_SIZE)
+	{
+		dict->exp_chunks = realloc(dict->exp_chunks,
+		                  (n / EXP_CHUNK_SIZE + 1) * sizeof(*dict->exp_chunks));
+		dict->exp_chunks[n / EXP_CHUNK_SIZE] = malloc(EXP_CHUNK_SIZE * sizeof(Exp));
+		dict->num_exp_chunks++;
+	}
+	return &dict->exp_chunks[n / EXP_CHUNK_SIZE][n % EXP_CHUNK_SIZE];
+}
+
+static E_list *shared_cell_new(Dictionary dict)
+{
+	size_t n = dict->num_exp_cells++;
+
+	if (0 == n % EXP_CHUNK_SIZE)
+	{
+		dict->exp_cell_chunks = realloc(dict->exp_cell_chunks,
+		             (n / EXP_CHUNK_SIZE + 1) * sizeof(*dict->exp_cell_chunks));
+		dict->exp_cell_chunks[n / EXP_CHUNK_SIZE] =
+			malloc(EXP_CHUNK_SIZE * sizeof(E_list));
+	}
+	return &dict->exp_cell_chunks[n / EXP_CHUNK_SIZE][n % EXP_CHUNK_SIZE];
+}
+
+/**
+ * Return the canonical node of e.
+ */
+static Exp *share_exp(Dictionary dict, Exp *e)
+{
+	struct exp_share_s *es = dict->exp_share;
+
+	if (0 <= exp_node_id(dict, e)) return e;
+
+	size_t n = 0;
+	if (CONNECTOR_type != e->type)
+	{
+		for (E_list *l = e->u.l; NULL != l; l = l->next)
+			n++;
+	}
+
+	Exp **child = alloca((n + 1) * sizeof(*child));
+	size_t i = 0;
+	if (CONNECTOR_type != e->type)
+	{
+		for (E_list *l = e->u.l; NULL != l; l = l->next)
+			child[i++] = share_exp(dict, l->e);
+	}
+
+	unsigned int hash = node_hash(e, child, n);
+
+	if (2 * (dict->num_exp_nodes + 1) > es->table_size) table_grow(es);
+	size_t h = hash & (es->table_size - 1);
+	for (; NULL != es->table[h].e; h = (h + 1) & (es->table_size - 1))
+	{
+		if ((es->table[h].hash == hash) && node_equal(es->table[h].e, e, child, n))
+			return es->table[h].e;
+	}
+
+	Exp *s = shared_node_new(dict);
+	*s = *e;
+	if (CONNECTOR_type != e->type)
+	{
+		E_list **lp = &s->u.l;
+
+		/* Not set for AND and OR nodes. */
+		s->dir = '\0';
+		s->multi = false;
+		for (i = 0; i < n; i++)
+		{
+			E_list *l = shared_cell_new(dict);
+			l->e = child[i];
+			*lp = l;
+			lp = &l->next;
+		}
+		*lp = NULL;
+	}
+
+	es->table[h].e = s;
+	es->table[h].hash = hash;
+	return s;
+}
+
+/**
+ * Remember the current end of an exp_list pool (which may not have been
+ * created yet).
+ */
+static void exp_list_mark(Pool_desc *mp, Pool_mark *m)
+{
+	if (NULL == mp)
+		memset(m, 0, sizeof(*m)); /* The start of the pool, once created */
+	else
+		pool_mark(mp, m);
+}
+
+/**
+ * Free the elements of an exp_list pool that have been allocated since
+ * the given mark. Return their number.
+ */
+static size_t exp_list_rewind(Pool_desc *mp, const Pool_mark *m)
+{
+	if (NULL == mp) return 0;
+
+	Pool_stats ps;
+	pool_get_stats(mp, &ps);
+	pool_rewind(mp, m);
+	return ps.curr_elements - m->curr_elements;
+}
+
+/**
+ * Count the nodes and E_list cells that remain in the dictionary
+ * exp_list, and free them.
+ */
+static void free_original_exps(Dictionary dict)
+{
+	struct exp_share_s *es = dict->exp_share;
+	Pool_stats ps;
+
+	if (NULL != dict->exp_list.Exp_pool)
+	{
+		pool_get_stats(dict->exp_list.Exp_pool, &ps);
+		es->num_nodes += ps.curr_elements;
+	}
+	if (NULL != dict->exp_list.E_list_pool)
+	{
+		pool_get_stats(dict->exp_list.E_list_pool, &ps);
+		es->num_cells += ps.curr_elements;
+	}
+	free_Exp_list(&dict->exp_list);
+}
+
+/* ======================================================== */
+
+/**
+ * Start sharing the expressions of the dictionary that is being read.
+ */
+void exp_share_init(Dictionary dict)
+{
+	if (dict->lazy_exps) return;
+
+	dict->exp_share = malloc(sizeof(struct exp_share_s));
+	memset(dict->exp_share, 0, sizeof(struct exp_share_s));
+	table_grow(dict->exp_share);
+}
+
+/**
+ * Note the start of the reading of the expression of a dictionary
+ * entry, for share_entry_expression().
+ */
+void share_entry_start(Dictionary dict)
+{
+	struct exp_share_s *es = dict->exp_share;
+
+	if (NULL == es) return;
+
+	exp_list_mark(dict->exp_list.Exp_pool, &es->Exp_mark);
+	exp_list_mark(dict->exp_list.E_list_pool, &es->E_list_mark);
+}
+
+/**
+ * Return the shared version of the expression of a dictionary entry
+ * that has just been read, and free its original nodes, which are the
+ * nodes that have been added to the dictionary exp_list since the call
+ * to share_entry_start(). If the expressions are not shared, return e.
+ */
+Exp *share_entry_expression(Dictionary dict, Exp *e)
+{
+	struct exp_share_s *es = dict->exp_share;
+
+	if (NULL == es) return e;
+
+	e = share_exp(dict, e);
+	es->num_nodes += exp_list_rewind(dict->exp_list.Exp_pool, &es->Exp_mark);
+	es->num_cells += exp_list_rewind(dict->exp_list.E_list_pool, &es->E_list_mark);
+	return e;
+}
+
+static void share_dict_nodes(Dictionary dict, Dict_node *dn)
+{
+	if (NULL == dn) return;
+	share_dict_nodes(dict, dn->left);
+	share_dict_nodes(dict, dn->right);
+	if (NULL != dn->exp) dn->exp = share_exp(dict, dn->exp);
+}
+
+/**
+ * Finish the sharing of the dictionary expressions after the dictionary
+ * has been read: Share the expressions that have been added after their
+ * entries have been read (idioms), and free the remaining original nodes.
+ */
+void share_expressions(Dictionary dict)
+{
+	struct exp_share_s *es = dict->exp_share;
+
+	if (NULL == es) return;
+
+	share_dict_nodes(dict, dict->root);
+	for (length_limit_def_t *l = dict->contable.length_limit_def;
+	     NULL != l; l = l->next)
+	{
+		if (NULL != l->defexp) l->defexp = share_exp(dict, (Exp *)l->defexp);
+	}
+	free_original_exps(dict);
+
+	lgdebug(D_USER_TIMES, "Info: Dictionary %s: Expressions: "
+	        "%zu nodes, %zu E_list cells (%zu bytes); "
+	        "shared: %zu nodes, %zu E_list cells (%zu bytes)\n",
+	        dict->name, es->num_nodes, es->num_cells,
+	        es->num_nodes * sizeof(Exp) + es->num_cells * sizeof(E_list),
+	        dict->num_exp_nodes, dict->num_exp_cells,
+	        dict->num_exp_nodes * sizeof(Exp) +
+	        dict->num_exp_cells * sizeof(E_list));
+
+	free(es->table);
+	free(es);
+	dict->exp_share = NULL;
+}
+
+void free_shared_expressions(Dictionary dict)
+{
+	if (NULL != dict->exp_share)
+	{
+		free(dict->exp_share->table);
+		free(dict->exp_share);
+		dict->exp_share = NULL;
+	}
+
+	for (size_t i = 0; i < dict->num_exp_chunks; i++)
+		free(dict->exp_chunks[i]);
+	free(dict->exp_chunks);
+
+	size_t num_cell_chunks =
+		(dict->num_exp_cells + EXP_CHUNK_SIZE - 1) / EXP_CHUNK_SIZE;
+	for (size_t i = 0; i < num_cell_chunks; i++)
+		free(dict->exp_cell_chunks[i]);
+	free(dict->exp_cell_chunks);
+
+	dict->exp_chunks = NULL;
+	dict->exp_cell_chunks = NULL;
+	dict->num_exp_chunks = 0;
+	dict->num_exp_nodes = 0;
+	dict->num_exp_cells = 0;
+}
@@ -0,0 +1,41 @@
+/*************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                      */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _EXP_SHARE_H
+#define _EXP_SHARE_H
+
+#include "dict-common.h"
+
+#define EXP_CHUNK_SIZE 4096 /* Shared nodes (or E_list cells) per chunk */
+
+void exp_share_init(Dictionary);
+void share_entry_start(Dictionary);
+Exp *share_entry_expression(Dictionary, Exp *);
+void share_expressions(Dictionary);
+void free_shared_expressions(Dictionary);
+
+/**
+ * Return the id of a shared expression node of the dictionary, or -1 if
+ * the node is not shared (the expressions are not shared, or the node
+ * has been created after the dictionary has been read).
+ * Identical sub-expressions have the same id.
+ */
+static inline int exp_node_id(const Dictionary dict, const Exp *e)
+{
+	for (size_t i = 0; i < dict->num_exp_chunks; i++)
+	{
+		const Exp *chunk = dict->exp_chunks[i];
+		if ((e >= chunk) && (e < chunk + EXP_CHUNK_SIZE))
+			return (int)(i * EXP_CHUNK_SIZE + (e - chunk));
+	}
+	return -1;
+}
+#endif /* _EXP_SHARE_H */
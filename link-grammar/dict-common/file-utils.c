@@ -175,12 +175,14 @@ static void *dict_file_open(const char *fullname, const void *how)
  * directory path cache.
  */
 #define NOTFOUND(fp) ((NULL == (fp)) ? " (Not found)" : "")
+
+/* Dictionary data directory path cache -- per-thread storage. */
+static TLS char *path_found;
+
 void * object_open(const char *filename,
                    void * (*opencb)(const char *, const void *),
                    const void * user_data)
 {
-	/* Dictionary data directory path cache -- per-thread storage. */
-	static TLS char *path_found;
 	char *completename = NULL;
 	void *fp = NULL;
 	char *data_dir = NULL;
@@ -275,6 +277,28 @@ void * object_open(const char *filename,
 }
 #undef NOTFOUND
 
+/**
+ * Return a copy of the directory path cache of object_open() of the
+ * current thread, or NULL if it is not set.
+ */
+char *object_open_get_path(void)
+{
+	return (NULL == path_found) ? NULL : strdup(path_found);
+}
+
+/**
+ * Set the directory path cache of object_open() of the current thread
+ * (NULL invalidates it). This lets a thread that reads a part of a
+ * dictionary find its files in the same directory as the thread that
+ * has started to read it.
+ */
+void object_open_set_path(const char *path)
+{
+	char *pf = path_found;
+	path_found = (NULL == path) ? NULL : strdup(path);
+	free(pf);
+}
+
 FILE *dictopen(const char *filename, const char *how)
 {
 	return object_open(filename, dict_file_open, how);
@@ -22,6 +22,8 @@ FILE * dictopen(const char *filename, const char *how);
 void * object_open(const char *filename,
                    void * (*opencb)(const char *, const void *),
                    const void * user_data);
+char * object_open_get_path(void);
+void object_open_set_path(const char *);
 
 bool file_exists(const char * dict_name);
 char * get_file_contents(const char *filename);
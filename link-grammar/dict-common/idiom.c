@@ -155,7 +155,7 @@ static Dict_node * make_idiom_Dict_nodes(Dictionary dict, const char * string)
 		s = strchr(s, '_');
 		if ((NULL != sm) && (s > sm)) s = NULL;
 		if (NULL != s) *s++ = '\0';
-		Dict_node *dn_new = (Dict_node *) malloc(sizeof (Dict_node));
+		Dict_node *dn_new = Dict_node_create(dict);
 		dn_new->right = dn;
 		dn = dn_new;
 		dn->string = string_set_add(t, dict->string_set);
@@ -251,8 +251,8 @@ void insert_idiom(Dictionary dict, Dict_node * dn)
 	nc->cost = 0;
 
 	n1 = Exp_create(&dict->exp_list);
-	n1->u.l = ell = (E_list *) malloc(sizeof(E_list));
-	ell->next = elr = (E_list *) malloc(sizeof(E_list));
+	n1->u.l = ell = E_list_create(&dict->exp_list);
+	ell->next = elr = E_list_create(&dict->exp_list);
 	elr->next = NULL;
 	ell->e = nc;
 	elr->e = no;
@@ -270,8 +270,8 @@ void insert_idiom(Dictionary dict, Dict_node * dn)
 		n1 = Exp_create(&dict->exp_list);
 		n1->type = AND_type;
 		n1->cost = 0;
-		n1->u.l = ell = (E_list *) malloc(sizeof(E_list));
-		ell->next = elr = (E_list *) malloc(sizeof(E_list));
+		n1->u.l = ell = E_list_create(&dict->exp_list);
+		ell->next = elr = E_list_create(&dict->exp_list);
 		elr->next = NULL;
 
 		nc = Exp_create(&dict->exp_list);
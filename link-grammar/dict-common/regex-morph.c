@@ -25,6 +25,7 @@
 #include "dict-common/dict-common.h"
 #include "dict-common/regex-morph.h"
 #include "link-includes.h"
+#include "utilities.h"       /* parallel_for() */
 
 
 /**
@@ -49,48 +50,89 @@ static void prt_regerror(const char *msg, const Regex_node *re, int rc)
 	free(errbuf);
 }
 
+/* REG_ENHANCED is needed for OS X to support \w etc. */
+#ifndef REG_ENHANCED
+#define REG_ENHANCED 0
+#endif
+
+typedef struct
+{
+	Regex_node **re;    /* The regexs to compile */
+	int *rc;            /* ... and their regcomp() return codes */
+} regex_compile_t;
+
+static void compile_regex(size_t i, void *arg)
+{
+	regex_compile_t *rcomp = arg;
+	Regex_node *re = rcomp->re[i];
+
+	/* Compile with default options (0) and default character
+	 * tables (NULL). */
+	/* re->re = pcre_compile(re->pattern, 0, &error, &erroroffset, NULL); */
+	regex_t *preg = (regex_t *) malloc (sizeof(regex_t));
+	re->re = preg;
+
+	rcomp->rc[i] = regcomp(preg, re->pattern, REG_NOSUB|REG_EXTENDED|REG_ENHANCED);
+}
+
 /**
  * Compiles all the given regexs. Returns 0 on success,
  * else an error code.
  */
 int compile_regexs(Regex_node *re, Dictionary dict)
 {
-	regex_t *preg;
-	int rc;
+	return compile_regexs_concurrently(re, dict, 1);
+}
 
-	while (re != NULL)
+/**
+ * Like compile_regexs(), but compile the regexs concurrently using up
+ * to nthreads threads. The errors are reported, and the regex names
+ * are checked, in the order of the regexs (as by compile_regexs()).
+ */
+int compile_regexs_concurrently(Regex_node *re, Dictionary dict, int nthreads)
+{
+	size_t n = 0;
+
+	for (Regex_node *r = re; r != NULL; r = r->next)
 	{
 		/* If re->re non-null, assume compiled already. */
-		if(re->re == NULL)
-		{
-			/* Compile with default options (0) and default character
-			 * tables (NULL). */
-			/* re->re = pcre_compile(re->pattern, 0, &error, &erroroffset, NULL); */
-			preg = (regex_t *) malloc (sizeof(regex_t));
-			re->re = preg;
+		if (r->re == NULL) n++;
+	}
+	if (0 == n) return 0;
 
-			/* REG_ENHANCED is needed for OS X to support \w etc. */
-#ifndef REG_ENHANCED
-#define REG_ENHANCED 0
-#endif
-			rc = regcomp(preg, re->pattern, REG_NOSUB|REG_EXTENDED|REG_ENHANCED);
-			if (rc)
-			{
-				prt_regerror("Failed to compile regex", re, rc);
-				return rc;
-			}
+	regex_compile_t rcomp =
+	{
+		.re = malloc(n * sizeof(*rcomp.re)),
+		.rc = malloc(n * sizeof(*rcomp.rc)),
+	};
+	n = 0;
+	for (Regex_node *r = re; r != NULL; r = r->next)
+		if (r->re == NULL) rcomp.re[n++] = r;
 
-			/* Check that the regex name is defined in the dictionary. */
-			if ((NULL != dict) && !boolean_dictionary_lookup(dict, re->name))
-			{
-				/* TODO: better error handing. Maybe remove the regex? */
-				prt_error("Error: Regex name %s not found in dictionary!\n",
-				       re->name);
-			}
+	parallel_for(n, nthreads, compile_regex, &rcomp);
+
+	int rc = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		if (rcomp.rc[i])
+		{
+			rc = rcomp.rc[i];
+			prt_regerror("Failed to compile regex", rcomp.re[i], rc);
+			break;
+		}
+
+		/* Check that the regex name is defined in the dictionary. */
+		if ((NULL != dict) && !boolean_dictionary_lookup(dict, rcomp.re[i]->name))
+		{
+			/* TODO: better error handing. Maybe remove the regex? */
+			prt_error("Error: Regex name %s not found in dictionary!\n",
+			       rcomp.re[i]->name);
 		}
-		re = re->next;
 	}
-	return 0;
+
+	free(rcomp.re);
+	free(rcomp.rc);
+	return rc;
 }
 
 /**
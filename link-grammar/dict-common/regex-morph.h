@@ -15,6 +15,7 @@
 #include "dict-common.h"
 
 int compile_regexs(Regex_node *, Dictionary);
+int compile_regexs_concurrently(Regex_node *, Dictionary, int);
 const char *match_regex(const Regex_node *, const char *);
 void free_regexs(Regex_node *);
 #endif /* _REGEX_MORPH_H */
@@ -11,15 +11,19 @@
 /*                                                                       */
 /*************************************************************************/
 
+#include <time.h>
+
 #include "api-structures.h"
 #include "dict-common/dict-affix.h"
 #include "dict-common/dict-api.h"
 #include "dict-common/dict-common.h"
 #include "dict-common/dict-impl.h"
 #include "dict-common/dict-utils.h"
+#include "dict-common/exp-share.h"
 #include "dict-common/file-utils.h"
 #include "dict-common/idiom.h"
 #include "dict-common/regex-morph.h"
+#include "parse/prune.h"              // For pp_prune_table_setup()
 #include "post-process/pp_knowledge.h"
 #include "read-dict.h"
 #include "read-regex.h"
@@ -33,6 +37,65 @@
 *
 ****************************************************************/
 
+static bool lazy_loading = false;
+static bool shared_expressions = false;
+static int loading_threads = 1;
+
+/**
+ * Set lazy loading for dictionaries created from now on.
+ * In this mode, the expressions of most dictionary entries are parsed
+ * only when one of their words is first looked up. This makes the
+ * dictionary smaller when only a part of the vocabulary is used (e.g.
+ * for short batch jobs). The dictionary files are kept open until the
+ * dictionary is deleted, since the expressions are read from them.
+ */
+void dictionary_set_lazy_loading(bool lazy)
+{
+	lazy_loading = lazy;
+}
+
+bool dictionary_get_lazy_loading(void)
+{
+	return lazy_loading;
+}
+
+/**
+ * Set expression sharing for dictionaries created from now on.
+ * In this mode, identical sub-expressions of the dictionary entries are
+ * replaced by a single node while the dictionary is read, so the
+ * dictionary takes less memory, and its identical sub-expressions can
+ * be recognized by their node id. The expressions are not shared in
+ * lazy loading mode.
+ */
+void dictionary_set_shared_expressions(bool share)
+{
+	shared_expressions = share;
+}
+
+bool dictionary_get_shared_expressions(void)
+{
+	return shared_expressions;
+}
+
+/**
+ * Set the number of threads that read the dictionaries created from now
+ * on. If it is greater than 1, the affix table, the post-processing
+ * knowledge files and the regex file of a dictionary are read
+ * concurrently with its main file, and its regexs are compiled
+ * concurrently. The resulting dictionary is the same. The main file
+ * itself (with its included and word files) is read by a single thread,
+ * since its entries refer to the previous ones. The default is 1.
+ */
+void dictionary_set_loading_threads(int nthreads)
+{
+	loading_threads = nthreads;
+}
+
+int dictionary_get_loading_threads(void)
+{
+	return loading_threads;
+}
+
 static void load_affix(Dictionary afdict, Dict_node *dn, int l)
 {
 	Dict_node * dnx = NULL;
@@ -74,7 +137,6 @@ static void load_affix(Dictionary afdict, Dict_node *dn, int l)
 		               /*notify_err*/true), string);
 
 		dnx = dn->left;
-		free(dn);
 	}
 }
 
@@ -92,6 +154,243 @@ static bool return_true(Dictionary dict, const char *name)
 	return true;
 }
 
+/* The parts of a dictionary that are read independently of each other
+ * (concurrently if loading_threads > 1). When they are read sequentially,
+ * this is also their reading order. */
+enum { DICT_PART, AFFIX_PART, REGEX_PART, PP_PART, NUM_DICT_PARTS };
+
+static const char *dict_part_name[NUM_DICT_PARTS] =
+{
+	"Read dictionary", "Read affix table", "Read regex file",
+	"Read knowledge files",
+};
+
+typedef struct
+{
+	Dictionary dict;
+	const char *lang;
+	const char *pp_name;
+	const char *cons_name;
+	const char *affix_name;
+	const char *regex_name;
+	char *path;                  /* Where the dictionary has been found */
+	bool ok[NUM_DICT_PARTS];
+	double time[NUM_DICT_PARTS]; /* Their load times */
+} dict_load_t;
+
+/** Return the wall-clock time in seconds. */
+static double wall_time(void)
+{
+#if !defined(_WIN32)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+#else
+	return ((double) clock())/CLOCKS_PER_SEC;
+#endif
+}
+
+static void print_load_time(Dictionary dict, const char *phase, double t)
+{
+	lgdebug(D_USER_TIMES, "Info: Dictionary %s: %-22s %7.3f seconds\n",
+	        dict->name, phase, t);
+}
+
+/**
+ * Look for the files in the directory of the dictionary, also when
+ * this is not the thread that has found it. Return the previous
+ * directory path cache of this thread, for restore_dict_path().
+ */
+static char *use_dict_path(dict_load_t *dl)
+{
+	char *path = object_open_get_path();
+	object_open_set_path(dl->path);
+	return path;
+}
+
+static void restore_dict_path(char *path)
+{
+	object_open_set_path(path);
+	free(path);
+}
+
+/* ======================================================== */
+/* Reading the files that the dictionary file refers to in advance. */
+
+static void add_prefetched_file(Dictionary dict, const char *name,
+                                size_t len, bool is_dict)
+{
+	for (size_t i = 0; i < dict->num_prefetched; i++)
+	{
+		const char *pname = dict->prefetched[i].name;
+		if ((0 == strncmp(pname, name, len)) && ('\0' == pname[len])) return;
+	}
+
+	dict->prefetched = realloc(dict->prefetched,
+		(dict->num_prefetched + 1) * sizeof(*dict->prefetched));
+	Prefetched_file *pf = &dict->prefetched[dict->num_prefetched++];
+	pf->name = strndup(name, len);
+	pf->contents = NULL;
+	pf->is_dict = is_dict;
+}
+
+/**
+ * Add the files that are referred to by the dictionary text "input"
+ * (word files and included dictionaries) to the files to be read in
+ * advance, by their names as read_entry() would read them. This is
+ * only a textual scan: A file that is missed here is read when its
+ * reference is reached, and a file that is not really referred to is
+ * just not used.
+ */
+static void find_file_refs(Dictionary dict, const char *input)
+{
+	const char *p = input;
+	bool include = false;
+
+	while ('\0' != *p)
+	{
+		if ('%' == *p)
+		{
+			while (('\0' != *p) && ('\n' != *p)) p++;
+			continue;
+		}
+		if (lg_isspace(*p))
+		{
+			p++;
+			continue;
+		}
+
+		const char *start = p;
+		const char *end;
+		bool quoted = ('"' == *p);
+		if (quoted)
+		{
+			start = ++p;
+			while (('\0' != *p) && ('"' != *p) && ('\n' != *p)) p++;
+			end = p;
+			if ('"' == *p) p++;
+		}
+		else
+		{
+			while (('\0' != *p) && !lg_isspace(*p) && (':' != *p) && (';' != *p))
+				p++;
+			end = p;
+			if (p == start) p++; /* A ':' or ';' */
+		}
+		size_t len = end - start;
+
+		if (include)
+		{
+			size_t skip_slash = ('/' == start[0]) ? 1 : 0;
+			add_prefetched_file(dict, start + skip_slash, len - skip_slash, true);
+			include = false;
+		}
+		else if (!quoted && ('/' == start[0]) && (1 < len) && ('.' != start[1]))
+		{
+			add_prefetched_file(dict, start + 1, len - 1, false);
+		}
+		else if (!quoted && (8 == len) && (0 == strncmp(start, "#include", len)))
+		{
+			include = true;
+		}
+	}
+}
+
+typedef struct
+{
+	dict_load_t *dl;
+	size_t start;   /* The first file to read */
+} prefetch_t;
+
+static void prefetch_file(size_t i, void *arg)
+{
+	prefetch_t *pt = arg;
+	Prefetched_file *pf = &pt->dl->dict->prefetched[pt->start + i];
+
+	char *path = use_dict_path(pt->dl);
+	pf->contents = get_file_contents(pf->name);
+	restore_dict_path(path);
+}
+
+/**
+ * Read concurrently the files that the dictionary file refers to,
+ * including those that the included dictionaries refer to.
+ */
+static void prefetch_dict_files(dict_load_t *dl)
+{
+	Dictionary dict = dl->dict;
+	prefetch_t pt = { .dl = dl, .start = 0 };
+
+	find_file_refs(dict, dict->input);
+	while (pt.start < dict->num_prefetched)
+	{
+		size_t num_prefetched = dict->num_prefetched;
+
+		parallel_for(num_prefetched - pt.start, loading_threads,
+		             prefetch_file, &pt);
+		for (size_t i = pt.start; i < num_prefetched; i++)
+		{
+			Prefetched_file *pf = &dict->prefetched[i];
+			if (pf->is_dict && (NULL != pf->contents))
+				find_file_refs(dict, pf->contents);
+		}
+		pt.start = num_prefetched;
+	}
+}
+
+static void free_prefetched_files(Dictionary dict)
+{
+	for (size_t i = 0; i < dict->num_prefetched; i++)
+	{
+		free((void *)dict->prefetched[i].name);
+		free(dict->prefetched[i].contents);
+	}
+	free(dict->prefetched);
+	dict->prefetched = NULL;
+	dict->num_prefetched = 0;
+}
+
+/* ======================================================== */
+
+static void read_dict_part(size_t i, void *arg)
+{
+	dict_load_t *dl = arg;
+	Dictionary dict = dl->dict;
+	double start = wall_time();
+
+	/* When reading sequentially, stop at the first failed part. */
+	if (1 >= loading_threads)
+	{
+		for (size_t p = 0; p < i; p++)
+			if (!dl->ok[p]) return;
+	}
+
+	char *path = use_dict_path(dl);
+
+	switch (i)
+	{
+		case DICT_PART:
+			dl->ok[i] = read_dictionary(dict);
+			break;
+		case AFFIX_PART:
+			dict->affix_table = dictionary_six(dl->lang, dl->affix_name,
+			                                   NULL, NULL, NULL, NULL);
+			dl->ok[i] = (NULL != dict->affix_table);
+			break;
+		case REGEX_PART:
+			dl->ok[i] = (0 == read_regex_file(dict, dl->regex_name));
+			break;
+		case PP_PART:
+			dict->base_knowledge  = pp_knowledge_open(dl->pp_name);
+			dict->hpsg_knowledge  = pp_knowledge_open(dl->cons_name);
+			dl->ok[i] = true;
+			break;
+	}
+
+	restore_dict_path(path);
+	dl->time[i] = wall_time() - start;
+}
+
 /**
  * Read dictionary entries from a wide-character string "input".
  * All other parts are read from files.
@@ -140,7 +439,10 @@ dictionary_six_str(const char * lang,
 		dict->lookup_wild = file_lookup_wild;
 		dict->free_lookup = free_llist;
 		dict->lookup = file_boolean_lookup;
+		/* Only a dictionary that is read from a file can be lazy. */
+		dict->lazy_exps = lazy_loading && (NULL != affix_name);
 		condesc_init(dict, 1<<13);
+		if (shared_expressions) exp_share_init(dict);
 	}
 	else
 	{
@@ -156,10 +458,6 @@ dictionary_six_str(const char * lang,
 	/* Read dictionary from the input string. */
 	dict->input = input;
 	dict->pin = dict->input;
-	if (!read_dictionary(dict))
-	{
-		goto failure;
-	}
 
 	if (NULL == affix_name)
 	{
@@ -168,12 +466,46 @@ dictionary_six_str(const char * lang,
 		 * Skip the rest of processing!
 		 * FIXME: The dictionary creating stuff needs a rearrangement.
 		 */
+		if (!read_dictionary(dict))
+		{
+			goto failure;
+		}
 		return dict;
 	}
 
+	double start = wall_time();
+	dict_load_t dl =
+	{
+		.dict = dict,
+		.lang = lang,
+		.pp_name = pp_name,
+		.cons_name = cons_name,
+		.affix_name = affix_name,
+		.regex_name = regex_name,
+		.path = object_open_get_path(),
+	};
+	if (1 < loading_threads)
+	{
+		double phase_start = wall_time();
+		prefetch_dict_files(&dl);
+		lgdebug(D_USER_TIMES, "Info: Dictionary %s: Read %zu referred files "
+		        "in %.3f seconds\n", dict->name, dict->num_prefetched,
+		        wall_time() - phase_start);
+	}
+	parallel_for(NUM_DICT_PARTS, loading_threads, read_dict_part, &dl);
+	free_prefetched_files(dict);
+	free(dl.path);
+
+	for (size_t i = 0; i < NUM_DICT_PARTS; i++)
+		print_load_time(dict, dict_part_name[i], dl.time[i]);
+
+	if (!dl.ok[DICT_PART])
+	{
+		goto failure;
+	}
+
 	dictionary_setup_locale(dict);
 
-	dict->affix_table = dictionary_six(lang, affix_name, NULL, NULL, NULL, NULL);
 	if (dict->affix_table == NULL)
 	{
 		prt_error("Error: Could not open affix file %s\n", affix_name);
@@ -190,14 +522,15 @@ dictionary_six_str(const char * lang,
 	 * We have to compile regexs using the dictionary locale,
 	 * so make a temporary locale swap.
 	 */
-	if (read_regex_file(dict, regex_name)) goto failure;
+	if (!dl.ok[REGEX_PART]) goto failure;
 
+	double phase_start = wall_time();
 	const char *locale = setlocale(LC_CTYPE, NULL); /* Save current locale. */
 	locale = strdupa(locale); /* setlocale() uses its own memory. */
 	setlocale(LC_CTYPE, dict->locale);
 	lgdebug(+D_DICT, "Regexs locale \"%s\"\n", setlocale(LC_CTYPE, NULL));
 
-	if (compile_regexs(dict->regex_root, dict))
+	if (compile_regexs_concurrently(dict->regex_root, dict, loading_threads))
 	{
 		locale = setlocale(LC_CTYPE, locale);         /* Restore the locale. */
 		assert(NULL != locale, "Cannot restore program locale");
@@ -205,16 +538,19 @@ dictionary_six_str(const char * lang,
 	}
 	locale = setlocale(LC_CTYPE, locale);            /* Restore the locale. */
 	assert(NULL != locale, "Cannot restore program locale");
+	print_load_time(dict, "Compile regexs", wall_time() - phase_start);
 
 #ifdef USE_CORPUS
 	dict->corpus = lg_corpus_new();
 #endif
 
-	dict->base_knowledge  = pp_knowledge_open(pp_name);
-	dict->hpsg_knowledge  = pp_knowledge_open(cons_name);
-
+	phase_start = wall_time();
 	dictionary_setup_defines(dict);
+	share_expressions(dict);
 	condesc_setup(dict);
+	pp_prune_table_setup(dict);
+	print_load_time(dict, "Set up dictionary", wall_time() - phase_start);
+	print_load_time(dict, "Total", wall_time() - start);
 
 	// Special-case hack.
 	if ((0 == strncmp(dict->lang, "any", 3)) ||
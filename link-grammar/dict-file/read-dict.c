@@ -16,6 +16,7 @@
 #include "dict-common/dict-affix.h"   // For is_stem()
 #include "dict-common/dict-common.h"
 #include "dict-common/dict-defines.h" // For SUBSCRIPT_MARK
+#include "dict-common/exp-share.h"
 #include "dict-common/file-utils.h"
 #include "dict-common/idiom.h"
 #include "dict-common/regex-morph.h"
@@ -115,6 +116,9 @@
 */
 
 static bool link_advance(Dictionary dict);
+static void resolve_lookup_list(Dictionary dict, Dict_node *llist);
+static void parse_unparsed_exp(Dictionary dict, Exp *e);
+static Lazy_file *lazy_file_open(Dictionary dict, const char *filename);
 
 static void dict_error2(Dictionary dict, const char * s, const char *s2)
 {
@@ -672,7 +676,7 @@ rdictionary_lookup(Dict_node *llist,
  *
  * The returned list must be freed with file_free_lookup().
  */
-Dict_node * file_lookup_list(const Dictionary dict, const char *s)
+static Dict_node * lookup_list(const Dictionary dict, const char *s)
 {
 	Dict_node * llist =
 		rdictionary_lookup(NULL, dict->root, s, true, dict_order_bare);
@@ -680,9 +684,17 @@ Dict_node * file_lookup_list(const Dictionary dict, const char *s)
 	return llist;
 }
 
+Dict_node * file_lookup_list(const Dictionary dict, const char *s)
+{
+	Dict_node * llist = lookup_list(dict, s);
+	resolve_lookup_list(dict, llist);
+	return llist;
+}
+
 bool file_boolean_lookup(Dictionary dict, const char *s)
 {
-	Dict_node *llist = file_lookup_list(dict, s);
+	/* The expressions are not needed, so don't parse them. */
+	Dict_node *llist = lookup_list(dict, s);
 	bool boool = (llist != NULL);
 	file_free_lookup(llist);
 	return boool;
@@ -699,17 +711,6 @@ void file_free_lookup(Dict_node *llist)
 	}
 }
 
-void free_insert_list(Dict_node *ilist)
-{
-	Dict_node * n;
-	while (ilist != NULL)
-	{
-		n = ilist->left;
-		free(ilist);
-		ilist = n;
-	}
-}
-
 /**
  * file_lookup_wild -- allows for wildcard searches (globs)
  * Used to support the !! command in the parser command-line tool.
@@ -732,6 +733,7 @@ Dict_node * file_lookup_wild(Dictionary dict, const char *s)
 	result =
 	 rdictionary_lookup(NULL, dict->root, stmp, lookup_idioms, dict_order_wild);
 	free(stmp);
+	resolve_lookup_list(dict, result);
 	return result;
 }
 
@@ -779,14 +781,47 @@ static Dict_node * strict_lookup_list(const Dictionary dict, const char *s)
 
 /* ======================================================================== */
 /**
- * Allocate a new Exp node and link it into the exp_list for freeing later.
+ * Allocate a new Exp node in the exp_list, for freeing later.
  */
 Exp * Exp_create(Exp_list *eli)
 {
-	Exp * e = malloc(sizeof(Exp));
-	e->next = eli->exp_list;
-	eli->exp_list = e;
-	return e;
+	if (NULL == eli->Exp_pool)
+	{
+		eli->Exp_pool = pool_new(__func__, "Exp", /*num_elements*/4096,
+		                         sizeof(Exp), /*zero_out*/false,
+		                         /*align*/false, /*exact*/false);
+	}
+	return pool_alloc(eli->Exp_pool);
+}
+
+/**
+ * Allocate a new E_list cell in the exp_list, for freeing later.
+ */
+E_list * E_list_create(Exp_list *eli)
+{
+	if (NULL == eli->E_list_pool)
+	{
+		eli->E_list_pool = pool_new(__func__, "E_list", /*num_elements*/4096,
+		                            sizeof(E_list), /*zero_out*/false,
+		                            /*align*/false, /*exact*/false);
+	}
+	return pool_alloc(eli->E_list_pool);
+}
+
+/**
+ * Allocate a new node of the dictionary word tree. The tree nodes are
+ * freed only with the dictionary.
+ */
+Dict_node * Dict_node_create(Dictionary dict)
+{
+	if (NULL == dict->Dict_node_pool)
+	{
+		dict->Dict_node_pool = pool_new(__func__, "Dict_node",
+		                          /*num_elements*/4096, sizeof(Dict_node),
+		                          /*zero_out*/false, /*align*/false,
+		                          /*exact*/false);
+	}
+	return pool_alloc(dict->Dict_node_pool);
 }
 
 /**
@@ -812,7 +847,7 @@ static Exp * make_unary_node(Exp_list * eli, Exp * e)
 	n = Exp_create(eli);
 	n->type = AND_type;  /* these must be AND types */
 	n->cost = 0.0;
-	n->u.l = (E_list *) malloc(sizeof(E_list));
+	n->u.l = E_list_create(eli);
 	n->u.l->next = NULL;
 	n->u.l->e = e;
 	return n;
@@ -831,8 +866,8 @@ static Exp * make_and_node(Exp_list * eli, Exp* nl, Exp* nr)
 	n->type = AND_type;
 	n->cost = 0.0;
 
-	n->u.l = ell = (E_list *) malloc(sizeof(E_list));
-	ell->next = elr = (E_list *) malloc(sizeof(E_list));
+	n->u.l = ell = E_list_create(eli);
+	ell->next = elr = E_list_create(eli);
 	elr->next = NULL;
 
 	ell->e = nl;
@@ -853,8 +888,8 @@ static Exp * make_or_node(Exp_list *eli, Exp* nl, Exp* nr)
 	n->type = OR_type;
 	n->cost = 0.0;
 
-	n->u.l = ell = (E_list *) malloc(sizeof(E_list));
-	ell->next = elr = (E_list *) malloc(sizeof(E_list));
+	n->u.l = ell = E_list_create(eli);
+	ell->next = elr = E_list_create(eli);
 	elr->next = NULL;
 
 	ell->e = nl;
@@ -937,6 +972,18 @@ static Exp * make_connector(Dictionary dict)
 			                 "Or perhaps a word is used before it is defined.");
 			return NULL;
 		}
+		/* The lookup is not resolved, since we may already be parsing
+		 * an unparsed expression, under the lock. */
+		if (UNPARSED_type == dn->exp->type)
+		{
+			if (dn->exp->u.unparsed->being_parsed)
+			{
+				file_free_lookup(dn_head);
+				dict_error(dict, "Circular reference to a word.");
+				return NULL;
+			}
+			parse_unparsed_exp(dict, dn->exp);
+		}
 		n = make_unary_node(&dict->exp_list, dn->exp);
 		file_free_lookup(dn_head);
 	}
@@ -974,11 +1021,7 @@ static Exp * make_connector(Dictionary dict)
 		}
 	}
 
-	if (!link_advance(dict))
-	{
-		free(n);
-		return NULL;
-	}
+	if (!link_advance(dict)) return NULL;
 	return n;
 }
 
@@ -990,11 +1033,29 @@ static Exp * make_connector(Dictionary dict)
  *  that has been eliminated. However, it is still used to support linking of
  *  quotes that don't get the QUc/QUd links.
  */
+/**
+ * Allocate an AND or OR node of a sentence expression, with the given
+ * two children. The sentence expressions are freed by free_Exp().
+ */
+static Exp * make_sentence_node(Exp_type type, Exp *nl, Exp *nr)
+{
+	Exp *n = malloc(sizeof(Exp));
+	E_list *ell = malloc(sizeof(E_list));
+	E_list *elr = malloc(sizeof(E_list));
+
+	n->type = type;
+	n->cost = 0.0;
+	n->u.l = ell;
+	ell->next = elr;
+	ell->e = nl;
+	elr->next = NULL;
+	elr->e = nr;
+	return n;
+}
+
 void add_empty_word(Dictionary const dict, X_node *x)
 {
 	Exp *zn, *an;
-	E_list *elist, *flist;
-	Exp_list eli = { NULL };
 	const char *ZZZ = string_set_add(EMPTY_CONNECTOR, dict->string_set);
 
 	/* The left-wall already has ZZZ-. The right-wall will not arrive here. */
@@ -1009,29 +1070,21 @@ void add_empty_word(Dictionary const dict, X_node *x)
 		//lgdebug(+0, "Processing '%s'\n", x->string);
 
 		/* zn points at {ZZZ+} */
-		zn = Exp_create(&eli);
+		zn = malloc(sizeof(Exp));
 		zn->dir = '+';
 		zn->u.condesc = condesc_add(&dict->contable, ZZZ);
 		zn->multi = false;
 		zn->type = CONNECTOR_type;
 		zn->cost = 0.0;
-		zn = make_optional_node(&eli, zn);
-
-		/* flist is plain-word-exp */
-		flist = (E_list *) malloc(sizeof(E_list));
-		flist->next = NULL;
-		flist->e = x->exp;
 
-		/* elist is {ZZZ+} , (plain-word-exp) */
-		elist = (E_list *) malloc(sizeof(E_list));
-		elist->next = flist;
-		elist->e = zn;
+		Exp *zeroary = malloc(sizeof(Exp));
+		zeroary->type = AND_type;
+		zeroary->cost = 0.0;
+		zeroary->u.l = NULL;
+		zn = make_sentence_node(OR_type, zeroary, zn);
 
 		/* an will be {ZZZ+} & (plain-word-exp) */
-		an = Exp_create(&eli);
-		an->type = AND_type;
-		an->cost = 0.0;
-		an->u.l = elist;
+		an = make_sentence_node(AND_type, zn, x->exp);
 
 		x->exp = an;
 	}
@@ -1343,6 +1396,236 @@ static Exp * restricted_expression(Dictionary dict, int and_ok, int or_ok)
 
 #endif
 
+/* ======================================================================== */
+/* Lazy expression parsing.
+ *
+ * In lazy loading mode (see dictionary_set_lazy_loading()), reading
+ * the dictionary only scans the expression of each entry, registering
+ * its connectors (they must all be known before condesc_setup()). The
+ * words get a placeholder Exp of UNPARSED_type, which holds the
+ * position of the expression text in its file. It is read and parsed
+ * when one of its words is first looked up, and then overwritten in
+ * place. The parsing uses the reader state in the Dictionary, so it is
+ * done under dict->exp_lock. The type of the placeholder is written
+ * last, so a lookup that finds it already parsed doesn't need the lock.
+ */
+
+/**
+ * Open the given dictionary file again, for reading the text of its
+ * unparsed expressions later. Return NULL if it cannot be opened, and
+ * then the expressions of this file are parsed when they are read.
+ */
+static Lazy_file *lazy_file_open(Dictionary dict, const char *filename)
+{
+	/* Binary mode, since the text offsets are counted in bytes. */
+	FILE *fp = dictopen(filename, "rb");
+	if (NULL == fp) return NULL;
+
+	Lazy_file *lf = malloc(sizeof(Lazy_file));
+	lf->fp = fp;
+	lf->name = string_set_add(filename, dict->string_set);
+	lf->next = dict->lazy_files;
+	dict->lazy_files = lf;
+
+	return lf;
+}
+
+/**
+ * Return true if the expression of the given entry words can be
+ * parsed on demand. Idioms and connector length limit definitions
+ * are needed when the dictionary is read, so they are not lazy.
+ */
+static bool is_lazy_entry(Dict_node *dn)
+{
+	if (NULL == dn) return false;
+
+	for (; NULL != dn; dn = dn->left)
+	{
+		if (contains_underbar(dn->string)) return false;
+		if (0 == strcmp(UNLIMITED_CONNECTORS_WORD, dn->string)) return false;
+		if (0 == strncmp(LIMITED_CONNECTORS_WORD, dn->string,
+		                 sizeof(LIMITED_CONNECTORS_WORD)-1))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Skip the expression that starts with the current token, up to the
+ * terminating ";", and register its connectors.
+ * Return a placeholder for the expression, whose text starts at exp_pin.
+ */
+static Exp * make_unparsed_exp(Dictionary dict, const char *exp_pin,
+                               int exp_line_number)
+{
+	while (!is_equal(dict, ';'))
+	{
+		size_t len = strlen(dict->token);
+
+		if (0 == len)
+		{
+			dict_error(dict, "Expecting \";\" at the end of an entry.");
+			return NULL;
+		}
+
+		char dir = dict->token[len-1];
+		if (!dict->is_special &&
+		    ((dir == '+') || (dir == '-') || (dir == ANY_DIR)))
+		{
+			if (!check_connector(dict, dict->token)) return NULL;
+
+			dict->token[len-1] = '\0';
+			const char *constring = dict->token;
+			if ('@' == constring[0]) constring++;
+			if (NULL == condesc_add(&dict->contable,
+			                 string_set_add(constring, dict->string_set)))
+				return NULL; /* Table ovf */
+		}
+
+		if (!link_advance(dict)) return NULL;
+	}
+
+	if (NULL == dict->Unparsed_exp_pool)
+	{
+		dict->Unparsed_exp_pool = pool_new(__func__, "Unparsed_exp",
+		                          /*num_elements*/4096, sizeof(Unparsed_exp),
+		                          /*zero_out*/false, /*align*/false,
+		                          /*exact*/false);
+	}
+
+	/* The ";" has been read, so the text ends just before dict->pin. */
+	Unparsed_exp *ue = pool_alloc(dict->Unparsed_exp_pool);
+	ue->file = dict->lazy_file;
+	ue->offset = exp_pin - dict->input;
+	ue->length = dict->pin - exp_pin;
+	ue->line_number = exp_line_number;
+	ue->being_parsed = false;
+
+	Exp *n = Exp_create(&dict->exp_list);
+	n->type = UNPARSED_type;
+	n->cost = 0.0;
+	n->u.unparsed = ue;
+	return n;
+}
+
+/**
+ * Read the text of the expression of the placeholder e from its file.
+ * Return it (to be freed by the caller), or NULL on error.
+ */
+static char *read_unparsed_exp(Unparsed_exp *ue)
+{
+	char *text = malloc(ue->length + 1);
+	FILE *fp = ue->file->fp;
+
+	if ((0 != fseek(fp, ue->offset, SEEK_SET)) ||
+	    (ue->length != fread(text, 1, ue->length, fp)) ||
+	    (';' != text[ue->length-1]))
+	{
+		prt_error("Error: %s: Cannot read the expression at line %d "
+		          "(has the file been changed?)\n",
+		          ue->file->name, ue->line_number);
+		free(text);
+		return NULL;
+	}
+	text[ue->length] = '\0';
+
+	return text;
+}
+
+/**
+ * Parse the expression of the placeholder e, and put it in e.
+ * On error, e becomes an empty expression (the error is reported).
+ * The reader state is saved and restored, since this may be called
+ * in the middle of parsing another expression.
+ */
+static void parse_unparsed_exp(Dictionary dict, Exp *e)
+{
+	Unparsed_exp *ue = e->u.unparsed;
+	char *token = strdupa(dict->token);
+	bool save_is_special       = dict->is_special;
+	const char * save_input    = dict->input;
+	const char * save_pin      = dict->pin;
+	const char * save_name     = dict->name;
+	const char * save_suppress = dict->suppress_warning;
+	int save_already_got_it    = dict->already_got_it;
+	int save_line_number       = dict->line_number;
+
+	char *text = read_unparsed_exp(ue);
+	Exp *n = NULL;
+
+	if (NULL != text)
+	{
+		dict->input = text;
+		dict->pin = text;
+		dict->name = ue->file->name;
+		dict->suppress_warning = NULL;
+		dict->already_got_it = '\0';
+		dict->line_number = ue->line_number;
+		ue->being_parsed = true;
+
+		if (link_advance(dict))
+		{
+			n = make_expression(dict);
+			if ((NULL != n) && !is_equal(dict, ';'))
+			{
+				dict_error(dict, "Expecting \";\" at the end of an entry.");
+				n = NULL;
+			}
+		}
+		free(text);
+	}
+
+	/* n itself remains unused in the exp_list. */
+	Exp parsed;
+	if (NULL == n)
+	{
+		parsed = (Exp){ .type = AND_type, .cost = 0.0, .u.l = NULL };
+	}
+	else
+	{
+		parsed = *n;
+	}
+
+	Exp_type type = parsed.type;
+	parsed.type = UNPARSED_type;
+	*e = parsed;
+	atomic_store_release(&e->type, type);
+
+	free((void *)dict->suppress_warning);
+	strcpy(dict->token, token);
+	dict->is_special       = save_is_special;
+	dict->input            = save_input;
+	dict->pin              = save_pin;
+	dict->name             = save_name;
+	dict->suppress_warning = save_suppress;
+	dict->already_got_it   = save_already_got_it;
+	dict->line_number      = save_line_number;
+}
+
+/**
+ * Parse the expression e if it has not been parsed yet.
+ */
+static void resolve_exp(Dictionary dict, Exp *e)
+{
+	if (UNPARSED_type != atomic_load_acquire(&e->type)) return;
+
+	spin_lock(&dict->exp_lock);
+	if (UNPARSED_type == e->type) parse_unparsed_exp(dict, e);
+	spin_unlock(&dict->exp_lock);
+}
+
+/**
+ * Parse the unparsed expressions in the given lookup list.
+ */
+static void resolve_lookup_list(Dictionary dict, Dict_node *llist)
+{
+	if (!dict->lazy_exps) return;
+
+	for (; NULL != llist; llist = llist->right)
+		resolve_exp(dict, llist->exp);
+}
+
 /* ======================================================================== */
 /* Implementation of the DSW algo for rebalancing a binary tree.
  * The point is -- after building the dictionary tree, we rebalance it
@@ -1592,7 +1875,6 @@ void insert_list(Dictionary dict, Dict_node * p, int l)
 		        "\tWords ending \".Ix\" (x a number) are reserved for idioms.\n"
 		        "\tThis word will be ignored.",
 		        dn->string, dict->line_number, dict->name);
-		free(dn);
 	}
 	else
 	{
@@ -1648,6 +1930,8 @@ void insert_list(Dictionary dict, Dict_node * p, int l)
 	insert_list(dict, dn_second_half, l-k-1);
 }
 
+static bool read_dictionary_entries(Dictionary);
+
 /**
  * read_entry() -- read one dictionary entry
  * Starting with the current token, parse one dictionary entry.
@@ -1693,6 +1977,7 @@ static bool read_entry(Dictionary dict)
 			const char * save_pin;
 			int save_already_got_it;
 			int save_line_number;
+			Lazy_file * save_lazy_file;
 			size_t skip_slash;
 
 			if (!link_advance(dict)) goto syntax_error;
@@ -1705,9 +1990,10 @@ static bool read_entry(Dictionary dict)
 			save_pin            = dict->pin;
 			save_already_got_it = dict->already_got_it;
 			save_line_number    = dict->line_number;
+			save_lazy_file      = dict->lazy_file;
 
 			/* OK, token contains the filename to read ... */
-			instr = get_file_contents(dict_name + skip_slash);
+			instr = get_dict_file_contents(dict, dict_name + skip_slash);
 			if (NULL == instr)
 			{
 				prt_error("Error: Could not open subdictionary \"%s\"\n", dict_name);
@@ -1715,13 +2001,16 @@ static bool read_entry(Dictionary dict)
 			}
 			dict->input = instr;
 			dict->pin = dict->input;
+			if (dict->lazy_exps)
+				dict->lazy_file = lazy_file_open(dict, dict_name + skip_slash);
 
 			/* The line number and dict name are used for error reporting */
 			dict->line_number = 0;
 			dict->name = dict_name;
 
-			/* Now read the thing in. */
-			rc = read_dictionary(dict);
+			/* Now read the thing in. The dictionary tree is rebalanced
+			 * only after the whole dictionary has been read. */
+			rc = read_dictionary_entries(dict);
 
 			dict->name           = save_name;
 			dict->is_special     = save_is_special;
@@ -1729,6 +2018,7 @@ static bool read_entry(Dictionary dict)
 			dict->pin            = save_pin;
 			dict->already_got_it = save_already_got_it;
 			dict->line_number    = save_line_number;
+			dict->lazy_file      = save_lazy_file;
 
 			free(instr);
 			if (!rc) goto syntax_error;
@@ -1746,7 +2036,7 @@ static bool read_entry(Dictionary dict)
 		}
 		else
 		{
-			Dict_node * dn_new = dict_node_new();
+			Dict_node * dn_new = Dict_node_create(dict);
 			dn_new->left = dn;
 			dn_new->right = NULL;
 			dn_new->exp = NULL;
@@ -1764,12 +2054,18 @@ static bool read_entry(Dictionary dict)
 	}
 
 	/* pass the : */
+	const char *exp_pin = dict->pin;
+	int exp_line_number = dict->line_number;
 	if (!link_advance(dict))
 	{
 		goto syntax_error;
 	}
 
-	n = make_expression(dict);
+	share_entry_start(dict);
+	if ((NULL != dict->lazy_file) && is_lazy_entry(dn))
+		n = make_unparsed_exp(dict, exp_pin, exp_line_number);
+	else
+		n = make_expression(dict);
 	if (n == NULL)
 	{
 		goto syntax_error;
@@ -1781,6 +2077,8 @@ static bool read_entry(Dictionary dict)
 		goto syntax_error;
 	}
 
+	n = share_entry_expression(dict, n);
+
 	/* At this point, dn points to a list of Dict_nodes connected by
 	 * their left pointers. These are to be inserted into the dictionary */
 	i = 0;
@@ -1798,28 +2096,25 @@ static bool read_entry(Dictionary dict)
 	}
 
 	/* pass the ; */
-	if (!link_advance(dict))
-	{
-		/* Avoid freeing dn, since it is already inserted into the dict. */
-		return false;
-	}
+	if (!link_advance(dict)) return false;
 
 	return true;
 
 syntax_error:
-	free_insert_list(dn);
+	/* The Dict_nodes in dn are freed with the dictionary. */
 	return false;
 }
 
 
-static void rprint_dictionary_data(Dict_node * n)
+static void rprint_dictionary_data(Dictionary dict, Dict_node * n)
 {
 	if (n == NULL) return;
-	rprint_dictionary_data(n->left);
+	rprint_dictionary_data(dict, n->left);
 	printf("%s: ", n->string);
+	if (dict->lazy_exps) resolve_exp(dict, n->exp);
 	print_expression(n->exp);
 	printf("-6-\n");
-	rprint_dictionary_data(n->right);
+	rprint_dictionary_data(dict, n->right);
 }
 
 /**
@@ -1829,10 +2124,10 @@ static void rprint_dictionary_data(Dict_node * n)
  */
 void print_dictionary_data(Dictionary dict)
 {
-	rprint_dictionary_data(dict->root);
+	rprint_dictionary_data(dict, dict->root);
 }
 
-bool read_dictionary(Dictionary dict)
+static bool read_dictionary_entries(Dictionary dict)
 {
 	if (!link_advance(dict))
 	{
@@ -1849,9 +2144,44 @@ bool read_dictionary(Dictionary dict)
 			return false;
 		}
 	}
+	return true;
+}
+
+bool read_dictionary(Dictionary dict)
+{
+	if (dict->lazy_exps) dict->lazy_file = lazy_file_open(dict, dict->name);
+	bool rc = read_dictionary_entries(dict);
+	dict->lazy_file = NULL;
+	if (!rc)
+	{
+		return false;
+	}
 	dict->root = dsw_tree_to_vine(dict->root);
 	dict->root = dsw_vine_to_tree(dict->root, dict->num_entries);
 	return true;
 }
 
+/**
+ * Return the contents of a file that is referred to by the dictionary
+ * (a word file or an included dictionary), or NULL if it cannot be
+ * read. If it has been read in advance (see dictionary_six_str()), it
+ * is taken from there. The caller should free it.
+ */
+char *get_dict_file_contents(Dictionary dict, const char *filename)
+{
+	for (size_t i = 0; i < dict->num_prefetched; i++)
+	{
+		Prefetched_file *pf = &dict->prefetched[i];
+
+		if ((NULL != pf->contents) && (0 == strcmp(pf->name, filename)))
+		{
+			char *contents = pf->contents;
+			pf->contents = NULL;
+			return contents;
+		}
+	}
+
+	return get_file_contents(filename);
+}
+
 /* ======================================================================= */
@@ -23,13 +23,13 @@ Dictionary dictionary_six(const char *lang, const char *dict_name,
                           const char *affix_name, const char *regex_name);
 Dictionary dictionary_create_from_file(const char *lang);
 bool read_dictionary(Dictionary dict);
+char *get_dict_file_contents(Dictionary dict, const char *filename);
 
 Dict_node * file_lookup_list(const Dictionary dict, const char *s);
 Dict_node * file_lookup_wild(Dictionary dict, const char *s);
 bool file_boolean_lookup(Dictionary dict, const char *s);
 void file_free_lookup(Dict_node *llist);
 
-void free_insert_list(Dict_node *ilist);
 void insert_list(Dictionary dict, Dict_node * p, int l);
 
 #endif /* _LG_READ_DICT_H_ */
@@ -40,27 +40,26 @@ void patch_subscript(char * s)
 }
 
 /**
- * Reads in one word from the file, allocates space for it,
- * and returns it.
+ * Reads in one word from the file contents at *pin, allocates space
+ * for it, and returns it. *pin is advanced past the word.
  *
  * In case of an error, return a null string (cannot be a valid word).
  */
-static const char * get_a_word(Dictionary dict, FILE * fp)
+static const char * get_a_word(Dictionary dict, const char ** pin)
 {
 	char word[MAX_WORD+4]; /* allow for 4-byte wide chars */
 	const char * s;
-	int c, j;
+	const char * p = *pin;
+	int j;
 
-	do {
-		c = fgetc(fp);
-	} while ((c != EOF) && lg_isspace(c));
-	if (c == EOF) return NULL;
+	while (('\0' != *p) && lg_isspace(*p)) p++;
+	if ('\0' == *p) return NULL;
 
-	for (j=0; (j <= MAX_WORD-1) && (!lg_isspace(c)) && (c != EOF); j++)
+	for (j=0; (j <= MAX_WORD-1) && (!lg_isspace(*p)) && ('\0' != *p); j++)
 	{
-		word[j] = c;
-		c = fgetc(fp);
+		word[j] = *p++;
 	}
+	*pin = p;
 
 	if (j >= MAX_WORD) {
 		word[MAX_WORD] = '\0';
@@ -75,7 +74,7 @@ static const char * get_a_word(Dictionary dict, FILE * fp)
 
 /**
  *
- * (1) opens the word file and adds it to the word file list
+ * (1) reads the word file and adds it to the word file list
  * (2) reads in the words
  * (3) puts each word in a Dict_node
  * (4) links these together by their left pointers at the
@@ -85,12 +84,13 @@ static const char * get_a_word(Dictionary dict, FILE * fp)
 Dict_node * read_word_file(Dictionary dict, Dict_node * dn, char * filename)
 {
 	Word_file * wf;
-	FILE * fp;
+	char * contents;
+	const char * pin;
 	const char * s;
 
 	filename += 1; /* get rid of leading '/' */
 
-	if ((fp = dictopen(filename, "r")) == NULL) {
+	if ((contents = get_dict_file_contents(dict, filename)) == NULL) {
 		return NULL;
 	}
 
@@ -100,20 +100,20 @@ Dict_node * read_word_file(Dictionary dict, Dict_node * dn, char * filename)
 	wf->next = dict->word_file_header;
 	dict->word_file_header = wf;
 
-	while ((s = get_a_word(dict, fp)) != NULL) {
+	pin = contents;
+	while ((s = get_a_word(dict, &pin)) != NULL) {
 		if ('\0' == s[0]) /* returned error indication */
 		{
-			fclose(fp);
-			free_insert_list(dn);
-			return NULL;
+			free(contents);
+			return NULL; /* The Dict_nodes are freed with the dictionary */
 		}
-		Dict_node * dn_new = malloc(sizeof(Dict_node));
+		Dict_node * dn_new = Dict_node_create(dict);
 		dn_new->left = dn;
 		dn = dn_new;
 		dn->string = s;
 		dn->file = wf;
 	}
-	fclose(fp);
+	free(contents);
 	return dn;
 }
 
@@ -20,6 +20,8 @@
 #include "tokenize/tok-structures.h"    // XXX TODO provide gword access methods!
 #include "tokenize/word-structures.h"
 
+#define D_DISJ 5 /* Debug level for this file. */
+
 /* Disjunct utilities ... */
 
 /**
@@ -37,20 +39,123 @@ void free_disjuncts(Disjunct *c)
 	}
 }
 
+/**
+ * Free the sentence disjuncts and connectors.
+ * They are all in one memory block (see build_sentence_disjuncts()).
+ */
 void free_sentence_disjuncts(Sentence sent)
 {
-	if (NULL != sent->disjuncts_connectors_memblock)
-	{
-		free(sent->disjuncts_connectors_memblock);
-		sent->disjuncts_connectors_memblock = NULL;
-	}
-	else
+	aligned_free(sent->disjuncts_connectors_memblock);
+	sent->disjuncts_connectors_memblock = NULL;
+	sent->disjuncts_connectors_memblock_sz = 0;
+	for (WordIdx i = 0; i < sent->length; i++)
+		sent->word[i].d = NULL;
+}
+
+/**
+ * Copy the sentence disjuncts and connectors to a new memory block, and
+ * set the disjunct lists of the given word array (of sent->length words)
+ * to point to the copy.
+ * The parser writes into the disjuncts (match_left, match_right), so
+ * this allows parsing the same sentence concurrently.
+ * Return the new memory block (to be freed by aligned_free()).
+ */
+void *copy_sentence_disjuncts(Sentence sent, Word *word)
+{
+	const char *oblock = sent->disjuncts_connectors_memblock;
+	const size_t sz = sent->disjuncts_connectors_memblock_sz;
+	char *nblock = aligned_alloc(CACHE_LINE_SIZE, sz);
+
+	memcpy(nblock, oblock, sz);
+
+#define IN_BLOCK(p) (((const char *)(p) >= oblock) && ((const char *)(p) < oblock + sz))
+#define RELOCATE(p) ((void *)((char *)(p) - oblock + nblock))
+
+	for (WordIdx w = 0; w < sent->length; w++)
 	{
-		for (WordIdx i = 0; i < sent->length; i++)
+		if (NULL == sent->word[w].d)
 		{
-			free_disjuncts(sent->word[i].d);
+			word[w].d = NULL;
+			continue;
+		}
+		word[w].d = RELOCATE(sent->word[w].d);
+
+		for (Disjunct *d = word[w].d; d != NULL; d = d->next)
+		{
+			if (NULL != d->next) d->next = RELOCATE(d->next);
+
+			for (int dir = 0; dir < 2; dir++)
+			{
+				Connector **cp = (0 == dir) ? &d->left : &d->right;
+				if (NULL == *cp) continue;
+				*cp = RELOCATE(*cp);
+
+				/* Connector tails may be shared (see share_connector_tails()).
+				 * A tail which points to the new block has already been
+				 * relocated. */
+				for (Connector *c = *cp; IN_BLOCK(c->next); c = c->next)
+					c->next = RELOCATE(c->next);
+			}
 		}
 	}
+#undef IN_BLOCK
+#undef RELOCATE
+
+	return nblock;
+}
+
+/* ============================================================= */
+
+/* Saving and restoring the sentence disjuncts.
+ *
+ * Pruning modifies the sentence disjuncts and connectors in place,
+ * and all the pointers it changes point into the sentence memory block.
+ * So the state of the disjuncts before the pruning can be saved by a
+ * plain copy of the memory block and the word disjunct lists, and
+ * restored by copying them back. */
+
+struct disjuncts_snapshot_s
+{
+	void *memblock;
+	size_t memblock_sz;
+	Disjunct **disjuncts;     /* The disjunct list of each word. */
+};
+
+disjuncts_snapshot_t *save_disjuncts(Sentence sent)
+{
+	disjuncts_snapshot_t *ds = malloc(sizeof(disjuncts_snapshot_t));
+
+	ds->memblock_sz = sent->disjuncts_connectors_memblock_sz;
+	ds->memblock = malloc(ds->memblock_sz);
+	memcpy(ds->memblock, sent->disjuncts_connectors_memblock, ds->memblock_sz);
+
+	ds->disjuncts = malloc(sent->length * sizeof(Disjunct *));
+	for (WordIdx w = 0; w < sent->length; w++)
+		ds->disjuncts[w] = sent->word[w].d;
+
+	return ds;
+}
+
+/**
+ * Restore the sentence disjuncts from the given snapshot.
+ * The snapshot is not freed.
+ */
+void restore_disjuncts(Sentence sent, disjuncts_snapshot_t *ds)
+{
+	assert(ds->memblock_sz == sent->disjuncts_connectors_memblock_sz,
+	       "Disjuncts memory block has been changed");
+
+	memcpy(sent->disjuncts_connectors_memblock, ds->memblock, ds->memblock_sz);
+	for (WordIdx w = 0; w < sent->length; w++)
+		sent->word[w].d = ds->disjuncts[w];
+}
+
+void free_disjuncts_snapshot(disjuncts_snapshot_t *ds)
+{
+	if (NULL == ds) return;
+	free(ds->memblock);
+	free(ds->disjuncts);
+	free(ds);
 }
 
 /**
@@ -173,107 +278,131 @@ static bool disjuncts_equal(Disjunct * d1, Disjunct * d2)
 }
 #endif
 
-/**
- * Duplicate the given connector chain.
- * If the argument is NULL, return NULL.
- */
-static Connector *connectors_dup(Connector *origc)
+/* ============================================================= */
+
+/* Sharing of identical trailing connector sequences ("tails").
+ *
+ * Disjuncts that result from the same expression cross-products often
+ * have identical connector sequences after their first connector.
+ * Since the memoizing tables of do_count() and the parse-set building
+ * use the connector addresses as a part of their keys, each such
+ * duplicate tail creates its own table entries. Sharing the tails makes
+ * identical sub-problems have the same key, so they are computed once.
+ *
+ * Connectors are shared only if all of their fields that are used after
+ * pruning are the same, and their own tails are already shared. The
+ * sharing is done in place, per word and direction. The connectors that
+ * become unreferenced remain in the sentence memory block. */
+
+typedef struct
 {
-	Connector head;
-	Connector *prevc = &head;
-	Connector *newc = &head;
-	Connector *t;
+	Connector **table;
+	size_t size;               /* Allocated table size (a power of 2). */
+	size_t mask;               /* Current table size - 1. */
+	size_t num_connectors;     /* Connectors before sharing (for stats). */
+	size_t num_shared;         /* Connectors after sharing (for stats). */
+} tail_table;
+
+static inline unsigned int hash_connector_tail(const Connector *c,
+                                               const Connector *next)
+{
+	unsigned int i = (unsigned int)(uintptr_t)c->desc;
 
-	for (t = origc; t != NULL;  t = t->next)
-	{
-		newc = connector_new(NULL, NULL);
-		*newc = *t;
+	i = c->nearest_word + (i << 6) + (i << 16) - i;
+	i = c->length_limit + (i << 6) + (i << 16) - i;
+	i = c->multi + (i << 6) + (i << 16) - i;
+	i = ((unsigned int)(uintptr_t)c->originating_gword) + (i << 6) + (i << 16) - i;
+	i = ((unsigned int)(uintptr_t)next) + (i << 6) + (i << 16) - i;
+	i += (i>>10);
 
-		prevc->next = newc;
-		prevc = newc;
-	}
-	newc->next = NULL;
+	return i;
+}
 
-	return head.next;
+static inline bool connector_tail_equal(const Connector *c1,
+                                        const Connector *c2,
+                                        const Connector *next2)
+{
+	return (c1->desc == c2->desc) && (c1->next == next2) &&
+	       (c1->nearest_word == c2->nearest_word) &&
+	       (c1->multi == c2->multi) &&
+	       (c1->length_limit == c2->length_limit) &&
+	       (c1->originating_gword == c2->originating_gword);
 }
 
 /**
- * Duplicate the given disjunct chain.
- * If the argument is NULL, return NULL.
+ * Prepare the table for sharing the tails of a new group of connector
+ * lists, which consist of num_connectors connectors.
+ * Tails are not shared across groups.
  */
-Disjunct *disjuncts_dup(Disjunct *origd)
+static void tail_table_reset(tail_table *tt, size_t num_connectors)
 {
-	Disjunct head;
-	Disjunct *prevd = &head;
-	Disjunct *newd = &head;
-	Disjunct *t;
+	size_t size = next_power_of_two_up(2 * num_connectors);
 
-	for (t = origd; t != NULL; t = t->next)
+	if (size > tt->size)
 	{
-		newd = (Disjunct *)xalloc(sizeof(Disjunct));
-		newd->word_string = t->word_string;
-		newd->cost = t->cost;
-		newd->left = connectors_dup(t->left);
-		newd->right = connectors_dup(t->right);
-		newd->originating_gword = t->originating_gword;
-		prevd->next = newd;
-		prevd = newd;
+		free(tt->table);
+		tt->table = malloc(size * sizeof(Connector *));
+		tt->size = size;
 	}
-	newd->next = NULL;
-
-	return head.next;
+	tt->mask = size - 1;
+	memset(tt->table, 0, size * sizeof(Connector *));
 }
 
-static Connector *pack_connectors_dup(Connector *origc, Connector **cblock)
+/**
+ * Return the shared copy of the given connector list.
+ * The tail is handled first, so the "next" field of the connector is
+ * already set to its shared tail when it is looked up. If the connector
+ * is not found, it becomes the shared copy.
+ */
+static Connector *connector_tail_share(Connector *c, tail_table *tt)
 {
-	Connector head;
-	Connector *prevc = &head;
-	Connector *newc = &head;
-	Connector *t;
-	Connector *lcblock = *cblock; /* Optimization. */
+	if (NULL == c) return NULL;
 
-	for (t = origc; t != NULL;  t = t->next)
-	{
-		newc = lcblock++;
-		*newc = *t;
+	Connector *next = connector_tail_share(c->next, tt);
+	unsigned int h = hash_connector_tail(c, next) & tt->mask;
+	Connector *s;
 
-		prevc->next = newc;
-		prevc = newc;
+	tt->num_connectors++;
+	/* Linear probing; the table is never more than half full. */
+	while (NULL != (s = tt->table[h]))
+	{
+		if (connector_tail_equal(s, c, next)) return s;
+		h = (h + 1) & tt->mask;
 	}
-	newc->next = NULL;
 
-	*cblock = lcblock;
-	return head.next;
+	c->next = next;
+	tt->table[h] = c;
+	tt->num_shared++;
+
+	return c;
 }
 
 /**
- * Duplicate the given disjunct chain.
- * If the argument is NULL, return NULL.
+ * Share identical connector tails in the disjuncts of each sentence
+ * word, separately for the left and right connector lists.
+ * This is to be done after the pruning, as the pruning modifies the
+ * connectors and would need to modify each connector use separately.
  */
-Disjunct *pack_disjuncts_dup(Disjunct *origd, Disjunct **dblock, Connector **cblock)
+void share_connector_tails(Sentence sent)
 {
-	Disjunct head;
-	Disjunct *prevd = &head;
-	Disjunct *newd = &head;
-	Disjunct *t;
-	Disjunct *ldblock = *dblock; /* Optimization. */
+	tail_table tt = (tail_table){0};
 
-	for (t = origd; t != NULL; t = t->next)
+	for (WordIdx w = 0; w < sent->length; w++)
 	{
-		newd = ldblock++;
-		newd->word_string = t->word_string;
-		newd->cost = t->cost;
-
-		newd->left = pack_connectors_dup(t->left, cblock);
-		newd->right = pack_connectors_dup(t->right, cblock);
-		newd->originating_gword = t->originating_gword;
-		prevd->next = newd;
-		prevd = newd;
+		Disjunct *d;
+
+		tail_table_reset(&tt, left_connector_count(sent->word[w].d));
+		for (d = sent->word[w].d; d != NULL; d = d->next)
+			d->left = connector_tail_share(d->left, &tt);
+
+		tail_table_reset(&tt, right_connector_count(sent->word[w].d));
+		for (d = sent->word[w].d; d != NULL; d = d->next)
+			d->right = connector_tail_share(d->right, &tt);
 	}
-	newd->next = NULL;
 
-	*dblock = ldblock;
-	return head.next;
+	lgdebug(+D_DISJ, "Connectors %zu, after tail sharing %zu\n",
+	        tt.num_connectors, tt.num_shared);
+	free(tt.table);
 }
 
 static disjunct_dup_table * disjunct_dup_table_new(size_t sz)
@@ -326,7 +455,7 @@ static gword_set *gword_set_element_new(gword_set *old_e)
  * Add an element to existing gword_set. Uniqueness is assumed.
  * @return A new set with the element.
  */
-static gword_set *gword_set_add(gword_set *gset, gword_set *ge)
+gword_set *gword_set_add(gword_set *gset, gword_set *ge)
 {
 	gword_set *n = gword_set_element_new(ge);
 	n->next = gset;
@@ -377,7 +506,8 @@ static gword_set *gword_set_union(gword_set *kept, gword_set *eliminated)
 /**
  * Takes the list of disjuncts pointed to by d, eliminates all
  * duplicates, and returns a pointer to a new list.
- * It frees the disjuncts that are eliminated.
+ * The eliminated disjuncts are not freed, as they are a part of the
+ * sentence disjuncts memory block.
  */
 Disjunct * eliminate_duplicate_disjuncts(Disjunct * d)
 {
@@ -405,13 +535,12 @@ Disjunct * eliminate_duplicate_disjuncts(Disjunct * d)
 		}
 		else
 		{
-			d->next = NULL;  /* to prevent it from freeing the whole list */
+			/* d is in the sentence memory block - just drop it. */
 			if (d->cost < dx->cost) dx->cost = d->cost;
 
 			dx->originating_gword =
 				gword_set_union(dx->originating_gword, d->originating_gword);
 
-			free_disjuncts(d);
 			count++;
 		}
 		d = dn;
@@ -48,10 +48,20 @@ Disjunct * catenate_disjuncts(Disjunct *, Disjunct *);
 Disjunct * eliminate_duplicate_disjuncts(Disjunct * );
 char * print_one_disjunct(Disjunct *);
 void word_record_in_disjunct(const Gword *, Disjunct *);
-Disjunct * disjuncts_dup(Disjunct *origd);
+gword_set *gword_set_add(gword_set *, gword_set *);
 int left_connector_count(Disjunct *);
 int right_connector_count(Disjunct *);
 
-Disjunct *pack_disjuncts_dup(Disjunct *, Disjunct **, Connector **);
+/* Alignment of the sentence disjuncts memory block. */
+#define CACHE_LINE_SIZE 64
+
+void *copy_sentence_disjuncts(Sentence, Word *);
+
+typedef struct disjuncts_snapshot_s disjuncts_snapshot_t;
+disjuncts_snapshot_t *save_disjuncts(Sentence);
+void restore_disjuncts(Sentence, disjuncts_snapshot_t *);
+void free_disjuncts_snapshot(disjuncts_snapshot_t *);
+
+void share_connector_tails(Sentence);
 
 #endif /* _LINK_GRAMMAR_DISJUNCT_UTILS_H_ */
@@ -93,6 +93,38 @@ link_public_api(int)
 link_public_api(bool)
      lg_error_flush(void);
 
+/**********************************************************************
+ *
+ * Memory pool statistics, see dictionary_get_pool_stats() and
+ * sentence_get_pool_stats().
+ *
+ ***********************************************************************/
+
+typedef struct
+{
+	const char *name;          /* The pool name */
+	size_t num_blocks;         /* Currently allocated blocks */
+	size_t num_huge_blocks;    /* Of them, blocks advised to use huge pages */
+	size_t bytes;              /* Total size of the allocated blocks */
+	size_t curr_elements;      /* Elements allocated since the last reuse */
+	size_t max_elements;       /* High-water mark of curr_elements */
+} lg_pool_stats;
+
+/**********************************************************************
+ *
+ * Parse result cache statistics, see dictionary_get_parse_cache_stats().
+ *
+ ***********************************************************************/
+
+typedef struct
+{
+	size_t lookups;            /* Sentences looked up in the cache */
+	size_t hits;               /* Of them, sentences found */
+	size_t evictions;          /* Entries evicted when the cache was full */
+	size_t num_entries;        /* Current number of cached sentences */
+	size_t bytes;              /* Their approximate memory size */
+} lg_parse_cache_stats;
+
 /**********************************************************************
  *
  * Functions to manipulate Dictionaries
@@ -109,10 +141,37 @@ link_public_api(const char *)
 link_public_api(void)
      dictionary_delete(Dictionary);
 
+typedef struct Dictionary_handle_s * Dictionary_handle;
+
+link_public_api(Dictionary_handle)
+     dictionary_handle_create(Dictionary);
+link_public_api(Dictionary)
+     dictionary_handle_get(Dictionary_handle);
+link_public_api(void)
+     dictionary_handle_set(Dictionary_handle, Dictionary);
+link_public_api(void)
+     dictionary_handle_delete(Dictionary_handle);
+
 link_public_api(void)
      dictionary_set_data_dir(const char * path);
 link_public_api(char *)
      dictionary_get_data_dir(void);
+link_public_api(void)
+     dictionary_set_lazy_loading(bool);
+link_public_api(bool)
+     dictionary_get_lazy_loading(void);
+link_public_api(void)
+     dictionary_set_shared_expressions(bool);
+link_public_api(bool)
+     dictionary_get_shared_expressions(void);
+link_public_api(void)
+     dictionary_set_loading_threads(int);
+link_public_api(int)
+     dictionary_get_loading_threads(void);
+link_public_api(size_t)
+     dictionary_get_pool_stats(Dictionary, lg_pool_stats *, size_t);
+link_public_api(void)
+     dictionary_get_parse_cache_stats(Dictionary, lg_parse_cache_stats *);
 link_public_api(FILE *)
 	  linkgrammar_open_data_file(const char *);
 
@@ -154,6 +213,10 @@ link_public_api(void)
      parse_options_set_disjunct_cost(Parse_Options opts, double disjunct_cost);
 link_public_api(double)
      parse_options_get_disjunct_cost(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_disjunct_budget(Parse_Options opts, int budget);
+link_public_api(int)
+     parse_options_get_disjunct_budget(Parse_Options opts);
 link_public_api(void)
      parse_options_set_min_null_count(Parse_Options opts, int null_count);
 link_public_api(int)
@@ -194,6 +257,10 @@ link_public_api(void)
      parse_options_set_use_sat_parser(Parse_Options opts, bool use_sat_solver);
 link_public_api(bool)
      parse_options_get_use_sat_parser(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_sat_eager_constraints(Parse_Options opts, bool val);
+link_public_api(bool)
+     parse_options_get_sat_eager_constraints(Parse_Options opts);
 #ifdef USE_VITERBI
 link_public_api(void)
      parse_options_set_use_viterbi(Parse_Options opts, bool use_viterbi);
@@ -218,6 +285,18 @@ link_public_api(void)
      parse_options_set_repeatable_rand(Parse_Options opts, bool val);
 link_public_api(bool)
      parse_options_get_repeatable_rand(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_share_connector_tails(Parse_Options opts, bool val);
+link_public_api(bool)
+     parse_options_get_share_connector_tails(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_threads(Parse_Options opts, int threads);
+link_public_api(int)
+     parse_options_get_threads(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_result_cache(Parse_Options opts, int kbytes);
+link_public_api(int)
+     parse_options_get_result_cache(Parse_Options opts);
 link_public_api(void)
      parse_options_reset_resources(Parse_Options opts);
 
@@ -282,6 +361,8 @@ link_public_api(int)
      sentence_link_cost(Sentence sent, LinkageIdx linkage_num);
 link_public_api(bool)
      sentence_display_wordgraph(Sentence sent, const char *modestr);
+link_public_api(size_t)
+     sentence_get_pool_stats(Sentence sent, lg_pool_stats *, size_t);
 
 /**********************************************************************
  *
@@ -15,6 +15,7 @@
 #include <string.h>
 
 #include "analyze-linkage.h"
+#include "api-structures.h"
 #include "connectors.h" // Needed for connector_string
 #include "linkage.h"
 #include "string-set.h"
@@ -68,19 +69,113 @@ static const char * intersect_strings(String_set *sset, const char * s, const ch
 	}
 }
 
+/* Link name memo.
+ * The link name depends only on the connector descriptors of the link
+ * endpoints. The same pairs repeat in many linkages, so the link names
+ * are memoized per sentence (they reside in the sentence string set). */
+
+typedef struct
+{
+	const condesc_t *ldesc;
+	const condesc_t *rdesc;
+	const char *link_name;
+} link_name_memo_entry;
+
+struct link_name_memo_s
+{
+	link_name_memo_entry *table;
+	size_t size;                 /* A power of 2 */
+	size_t count;
+};
+
+#define LINK_NAME_MEMO_INIT_SIZE 256
+
+static unsigned int hash_desc_pair(const condesc_t *ld, const condesc_t *rd)
+{
+	unsigned int i = (unsigned int)(uintptr_t)ld;
+
+	i = ((unsigned int)(uintptr_t)rd) + (i << 6) + (i << 16) - i;
+	i += (i>>10);
+
+	return i;
+}
+
+static void link_name_memo_grow(link_name_memo *lm)
+{
+	link_name_memo_entry *old_table = lm->table;
+	size_t old_size = lm->size;
+
+	lm->size = (0 == old_size) ? LINK_NAME_MEMO_INIT_SIZE : 2 * old_size;
+	lm->table = calloc(lm->size, sizeof(link_name_memo_entry));
+
+	for (size_t i = 0; i < old_size; i++)
+	{
+		link_name_memo_entry *e = &old_table[i];
+		if (NULL == e->link_name) continue;
+
+		unsigned int h = hash_desc_pair(e->ldesc, e->rdesc) & (lm->size - 1);
+		while (NULL != lm->table[h].link_name) h = (h + 1) & (lm->size - 1);
+		lm->table[h] = *e;
+	}
+	free(old_table);
+}
+
+/**
+ * Return the name of a link between the given connectors.
+ */
+static const char *link_name_get(Sentence sent, const Connector *lc,
+                                 const Connector *rc)
+{
+	link_name_memo *lm = sent->link_name_memo;
+
+	if (NULL == lm)
+	{
+		lm = sent->link_name_memo = calloc(1, sizeof(link_name_memo));
+		link_name_memo_grow(lm);
+	}
+
+	unsigned int h = hash_desc_pair(lc->desc, rc->desc) & (lm->size - 1);
+	link_name_memo_entry *e;
+
+	/* Linear probing; the table is never more than half full. */
+	for (e = &lm->table[h]; NULL != e->link_name; e = &lm->table[h])
+	{
+		if ((e->ldesc == lc->desc) && (e->rdesc == rc->desc))
+			return e->link_name;
+		h = (h + 1) & (lm->size - 1);
+	}
+
+	e->ldesc = lc->desc;
+	e->rdesc = rc->desc;
+	e->link_name = intersect_strings(sent->string_set,
+	                                 connector_string(lc),
+	                                 connector_string(rc));
+	const char *link_name = e->link_name;
+
+	if (2 * ++lm->count > lm->size) link_name_memo_grow(lm);
+	return link_name;
+}
+
+void free_link_name_memo(Sentence sent)
+{
+	if (NULL == sent->link_name_memo) return;
+	free(sent->link_name_memo->table);
+	free(sent->link_name_memo);
+	sent->link_name_memo = NULL;
+}
+
 /**
  * The name of the link is set to be the GCD of the names of
  * its two endpoints. Must be called after each extract_links(),
  * etc. since that call issues a brand-new set of links into
  * parse_info.
  */
-void compute_link_names(Linkage lkg, String_set *sset)
+void compute_link_names(Linkage lkg)
 {
 	size_t i;
 	for (i = 0; i < lkg->num_links; i++)
 	{
-		lkg->link_array[i].link_name = intersect_strings(sset,
-			connector_string(lkg->link_array[i].lc),
-			connector_string(lkg->link_array[i].rc));
+		lkg->link_array[i].link_name = link_name_get(lkg->sent,
+			lkg->link_array[i].lc, lkg->link_array[i].rc);
 	}
 }
@@ -16,5 +16,6 @@
 #include "api-types.h"
 #include "link-includes.h"
 
-void compute_link_names(Linkage, String_set *);
+void compute_link_names(Linkage);
+void free_link_name_memo(Sentence);
 #endif /* _ANALYZE_LINKAGE_H */
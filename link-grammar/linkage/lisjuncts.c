@@ -22,6 +22,7 @@
 #include "disjunct-utils.h"
 #include "linkage.h"
 #include "lisjuncts.h"
+#include "string-set.h"
 
 /* Links are *always* less than 10 chars long . For now. The estimate
  * below is somewhat dangerous .... could be  fixed. */
@@ -35,25 +36,33 @@
  */
 static char * reversed_conlist_str(Connector* c, char dir, char* buf, size_t sz)
 {
-	char* p;
-	size_t len = 0;
-
-	if (NULL == c) return buf;
-	p = reversed_conlist_str(c->next, dir, buf, sz);
+	char* p = buf;
+	size_t num = 0;
 
-	sz -= (p-buf);
+	for (Connector *t = c; NULL != t; t = t->next) num++;
+	if (0 == num) return buf;
 
-	if (c->multi)
-		p[len++] = '@';
+	Connector **rev = alloca(num * sizeof(Connector *));
+	for (size_t i = num; NULL != c; c = c->next) rev[--i] = c;
 
-	len += lg_strlcpy(p+len, connector_string(c), sz-len);
-	if (3 < sz-len)
+	for (size_t i = 0; i < num; i++)
 	{
-		p[len++] = dir;
-		p[len++] = ' ';
-		p[len] = 0x0;
+		size_t len = 0;
+
+		if (rev[i]->multi)
+			p[len++] = '@';
+
+		len += lg_strlcpy(p+len, connector_string(rev[i]), sz-len);
+		if (3 < sz-len)
+		{
+			p[len++] = dir;
+			p[len++] = ' ';
+			p[len] = 0x0;
+		}
+		p += len;
+		sz -= len;
 	}
-	return p+len;
+	return p;
 }
 
 /**
@@ -84,14 +93,14 @@ void lg_compute_disjunct_strings(Linkage lkg)
 	size_t nwords = lkg->num_words;
 
 	if (lkg->disjunct_list_str) return;
-	lkg->disjunct_list_str = (char **) malloc(nwords * sizeof(char *));
-	memset(lkg->disjunct_list_str, 0, nwords * sizeof(char *));
+	lkg->disjunct_list_str = malloc(nwords * sizeof(char *));
 
 	for (WordIdx w=0; w< nwords; w++)
 	{
 		Disjunct* dj = lkg->chosen_disjuncts[w];
 		disjunct_str(dj, djstr, sizeof(djstr));
 
-		lkg->disjunct_list_str[w] = strdup(djstr);
+		/* Identical disjuncts across linkages share their string. */
+		lkg->disjunct_list_str[w] = string_set_add(djstr, lkg->sent->string_set);
 	}
 }
@@ -12,6 +12,10 @@
 #include <errno.h>                      // errno
 #include <string.h>                     // strerror_r
 
+#ifdef HAVE_MADVISE
+#include <sys/mman.h>                   // madvise
+#endif
+
 #include "error.h"
 #include "memory-pool.h"
 #include "utilities.h"                  // MIN, MAX, aligned alloc
@@ -39,7 +43,16 @@ static size_t align_size(size_t element_size)
 	return element_size;
 }
 
-/* The address of the next allocated block is at the end of the block. */
+#define POOL_BLOCK_HEADER(blk) ((Pool_block_header *)(blk))
+
+/**
+ * Return the data size of a block with the given total size, rounded
+ * down to an integral number of elements.
+ */
+static size_t block_data_size(const Pool_desc *mp, size_t block_size)
+{
+	return (block_size - mp->header_size) / mp->element_size * mp->element_size;
+}
 
 /**
  * Create a memory pool descriptor.
@@ -48,6 +61,10 @@ static size_t align_size(size_t element_size)
  *    pool_alloc();
  * 3. Chain the pool descriptor to the given pool_list, so it can be
  *    automatically freed.
+ *
+ * The first block has room for num_elements elements. Each additional
+ * block is twice the size of the previous one, up to POOL_MAX_BLOCK_SIZE
+ * (unless the first block is already bigger).
  */
 Pool_desc *pool_new(const char *func, const char *name,
                     size_t num_elements, size_t element_size,
@@ -63,24 +80,27 @@ Pool_desc *pool_new(const char *func, const char *name,
 		mp->element_size = align_size(element_size);
 		mp->alignment = MAX(MIN_ALIGNMENT, mp->element_size);
 		mp->alignment = MIN(MAX_ALIGNMENT, mp->alignment);
-		mp->data_size = num_elements * mp->element_size;
-		mp->block_size = ALIGN(mp->data_size + FLDSIZE_NEXT, mp->alignment);
 	}
 	else
 	{
 		mp->element_size = element_size;
 		mp->alignment = MIN_ALIGNMENT;
-		mp->data_size = num_elements * mp->element_size;
-		mp->block_size = mp->data_size + FLDSIZE_NEXT;
 	}
+	mp->header_size = ALIGN(sizeof(Pool_block_header), mp->alignment);
+	mp->next_data_size = num_elements * mp->element_size;
 
 	mp->zero_out = zero_out;
 	mp->exact = exact;
 	mp->alloc_next = NULL;
+	mp->alloc_end = NULL;
 	mp->chain = NULL;
 	mp->ring = NULL;
 	mp->free_list = NULL;
+	mp->num_blocks = 0;
+	mp->num_huge_blocks = 0;
+	mp->bytes = 0;
 	mp->curr_elements = 0;
+	mp->max_elements = 0;
 	mp->num_elements = num_elements;
 
 	lgdebug(+D_MEMPOOL, "%sElement size %zu, alignment %zu (pool '%s' created in %s())\n",
@@ -90,35 +110,144 @@ Pool_desc *pool_new(const char *func, const char *name,
 }
 
 /**
- * Delete the given memory pool.
+ * Get the statistics of the given pool.
  */
-void pool_delete(Pool_desc *mp)
+void pool_get_stats(const Pool_desc *mp, Pool_stats *ps)
 {
-	if (NULL == mp) return;
-	lgdebug(+D_MEMPOOL, "Used %zu elements (pool '%s' created in %s())\n",
-	        mp->curr_elements, mp->name, mp->func);
+	ps->name = mp->name;
+	ps->num_blocks = mp->num_blocks;
+	ps->num_huge_blocks = mp->num_huge_blocks;
+	ps->bytes = mp->bytes;
+	ps->curr_elements = mp->curr_elements;
+	ps->max_elements = MAX(mp->max_elements, mp->curr_elements);
+}
 
-	/* Free its chained memory blocks. */
-	char *c_next;
-	size_t alloc_size;
-#if POOL_ALLOCATOR
-	alloc_size = mp->data_size;
-#else
-	alloc_size = mp->element_size;
-#endif
-	for (char *c = mp->chain; c != NULL; c = c_next)
+/**
+ * Get the statistics of the pools of the given list, which may contain
+ * NULL entries for pools that have not been created (they are skipped).
+ * Up to n entries are stored in stats.
+ * Return the number of the existing pools, which may be more than n.
+ */
+size_t pool_list_get_stats(Pool_desc *const *pools, size_t num_pools,
+                           Pool_stats *stats, size_t n)
+{
+	size_t num_existing = 0;
+
+	for (size_t i = 0; i < num_pools; i++)
 	{
-		c_next = POOL_NEXT_BLOCK(c, alloc_size);
+		if (NULL == pools[i]) continue;
+		if (num_existing < n) pool_get_stats(pools[i], &stats[num_existing]);
+		num_existing++;
+	}
+
+	return num_existing;
+}
+
+static void pool_debug_stats(const Pool_desc *mp, const char *when)
+{
+	if (!verbosity_level(+D_MEMPOOL)) return;
+
+	Pool_stats ps;
+	pool_get_stats(mp, &ps);
+	lgdebug(+D_MEMPOOL, "%s: Used %zu elements (max %zu), %zu blocks "
+	        "(%zu huge), %zu bytes (pool '%s' created in %s())\n",
+	        when, ps.curr_elements, ps.max_elements, ps.num_blocks,
+	        ps.num_huge_blocks, ps.bytes, mp->name, mp->func);
+}
+
 #if POOL_ALLOCATOR
-		aligned_free(c);
-#else
-		free(c);
+static void pool_free_block(Pool_desc *mp, char *blk)
+{
+	Pool_block_header *bh = POOL_BLOCK_HEADER(blk);
+
+	mp->num_blocks--;
+	if (bh->huge) mp->num_huge_blocks--;
+	mp->bytes -= bh->block_size;
+	aligned_free(blk);
+}
+
+/**
+ * Free the blocks starting at blk.
+ */
+static void pool_free_chain(Pool_desc *mp, char *blk)
+{
+	char *blk_next;
+
+	for (; blk != NULL; blk = blk_next)
+	{
+		blk_next = POOL_BLOCK_HEADER(blk)->next;
+		pool_free_block(mp, blk);
+	}
+}
+
+/**
+ * Allocate a new block, of size according to the current growth step.
+ * Big blocks are allocated on a huge page boundary and advised to use
+ * transparent huge pages.
+ */
+static char *pool_new_block(Pool_desc *mp)
+{
+	size_t block_size = mp->header_size + mp->next_data_size;
+	size_t alignment = mp->alignment;
+	bool huge = false;
+
+#if defined HAVE_MADVISE && defined MADV_HUGEPAGE
+	if ((POOL_HUGE_PAGE_SIZE > 0) && (block_size >= POOL_HUGE_PAGE_SIZE))
+	{
+		alignment = POOL_HUGE_PAGE_SIZE;
+		huge = true;
+	}
 #endif
+	block_size = ALIGN(block_size, alignment);
+
+	char *blk = aligned_alloc(alignment, block_size);
+	if (NULL == blk)
+	{
+		/* aligned_alloc() has strict requirements. */
+		char errbuf[64];
+		strerror_r(errno, errbuf, sizeof(errbuf));
+		assert(NULL != blk, "Block/element sizes %zu/%zu: %s",
+		       block_size, mp->element_size, errbuf);
 	}
+
+#if defined HAVE_MADVISE && defined MADV_HUGEPAGE
+	if (huge && (0 != madvise(blk, block_size, MADV_HUGEPAGE)))
+		huge = false; /* Not supported - just a regular block. */
+#endif
+
+	Pool_block_header *bh = POOL_BLOCK_HEADER(blk);
+	bh->next = NULL;
+	bh->data_size = block_data_size(mp, block_size);
+	bh->block_size = block_size;
+	bh->huge = huge;
+
+	mp->num_blocks++;
+	if (huge) mp->num_huge_blocks++;
+	mp->bytes += block_size;
+
+	/* Geometric growth of the next block, up to the maximum size. */
+	size_t max_data_size = block_data_size(mp, POOL_MAX_BLOCK_SIZE);
+	if (2 * mp->next_data_size <= max_data_size)
+		mp->next_data_size *= 2;
+	else
+		mp->next_data_size = MAX(mp->next_data_size, max_data_size);
+
+	return blk;
+}
+
+/**
+ * Delete the given memory pool.
+ */
+void pool_delete(Pool_desc *mp)
+{
+	if (NULL == mp) return;
+	pool_debug_stats(mp, "Deleted");
+
+	/* Free its chained memory blocks. */
+	pool_free_chain(mp, mp->chain);
 	free(mp);
 }
 
-#if POOL_ALLOCATOR
 /**
  * Allocate an element from the requested pool.
  * This function uses the feature that pointers to void and char are
@@ -143,43 +272,30 @@ void *pool_alloc(Pool_desc *mp)
 
 	mp->curr_elements++; /* For stats. */
 
-	if ((NULL == mp->alloc_next) || (mp->alloc_next == mp->ring + mp->data_size))
+	if (mp->alloc_next == mp->alloc_end)
 	{
-		assert(!mp->exact || (NULL == mp->alloc_next),
+		assert(!mp->exact || (NULL == mp->ring),
 				 "Too many elements %zu>%zu (pool '%s' created in %s())",
 				 mp->curr_elements, mp->num_elements, mp->name, mp->func);
 
 		/* No current block or current block exhausted - obtain another one. */
-		char *prev = mp->ring; /* Remember current block for possible chaining. */
-		if (NULL != mp->ring)
-		{
-			/* Next block already exists. */
-			mp->ring = POOL_NEXT_BLOCK(mp->ring, mp->data_size);
-		}
+		char *blk =
+			(NULL == mp->ring) ? mp->chain : POOL_BLOCK_HEADER(mp->ring)->next;
 
-		if (NULL == mp->ring)
+		if (NULL == blk)
 		{
 			/* Allocate a new block and chain it. */
-			mp->ring = aligned_alloc(mp->alignment, mp->block_size);
+			blk = pool_new_block(mp);
 			if (NULL == mp->ring)
-			{
-				/* aligned_alloc() has strict requirements. */
-				char errbuf[64];
-				strerror_r(errno, errbuf, sizeof(errbuf));
-				assert(NULL != mp->ring, "Block/element sizes %zu/%zu: %s",
-				       mp->block_size, mp->element_size, errbuf);
-			}
-			if (NULL == mp->alloc_next)
-				mp->chain = mp->ring; /* This is the start of the chain. */
+				mp->chain = blk; /* This is the start of the chain. */
 			else
-				POOL_NEXT_BLOCK(prev, mp->data_size) = mp->ring;
-			POOL_NEXT_BLOCK(mp->ring, mp->data_size) = NULL;
-			//printf("New ring %p next %p\n", mp->ring,
-			       //POOL_NEXT_BLOCK(mp->ring, mp->data_size));
+				POOL_BLOCK_HEADER(mp->ring)->next = blk;
 		} /* Else reuse existing block. */
 
-		if (mp->zero_out) memset(mp->ring, 0, mp->data_size);
-		mp->alloc_next = mp->ring;
+		mp->ring = blk;
+		mp->alloc_next = blk + mp->header_size;
+		mp->alloc_end = mp->alloc_next + POOL_BLOCK_HEADER(blk)->data_size;
+		if (mp->zero_out) memset(mp->alloc_next, 0, mp->alloc_end - mp->alloc_next);
 	}
 
 	/* Grab a new element. */
@@ -190,16 +306,60 @@ void *pool_alloc(Pool_desc *mp)
 
 /**
  * Reuse the given memory pool.
- * Reset the pool pointers without freeing its memory.
- * pool_alloc() will then reuse the existing pool blocks before allocating
- * new blocks.
+ * Reset the pool pointers. pool_alloc() will then reuse the existing
+ * pool blocks before allocating new blocks.
+ *
+ * Blocks that have not been used since the previous reuse (i.e. those
+ * after the current one) are returned to the OS, so a pool that once
+ * grew big doesn't keep its peak memory forever.
  */
 void pool_reuse(Pool_desc *mp)
 {
-	lgdebug(+D_MEMPOOL, "Used %zu elements (pool '%s' created in %s())\n",
-	        mp->curr_elements, mp->name, mp->func);
-	mp->ring = mp->chain;
-	mp->alloc_next = mp->ring;
+	pool_debug_stats(mp, "Reused");
+
+	if (NULL == mp->ring)
+	{
+		pool_free_chain(mp, mp->chain);
+		mp->chain = NULL;
+	}
+	else
+	{
+		pool_free_chain(mp, POOL_BLOCK_HEADER(mp->ring)->next);
+		POOL_BLOCK_HEADER(mp->ring)->next = NULL;
+	}
+
+	mp->ring = NULL;
+	mp->alloc_next = NULL;
+	mp->alloc_end = NULL;
+	mp->free_list = NULL;
+	mp->max_elements = MAX(mp->max_elements, mp->curr_elements);
+	mp->curr_elements = 0;
+}
+
+/**
+ * Remember the current allocation position of the given pool.
+ */
+void pool_mark(const Pool_desc *mp, Pool_mark *m)
+{
+	m->ring = mp->ring;
+	m->alloc_next = mp->alloc_next;
+	m->alloc_end = mp->alloc_end;
+	m->chain = mp->chain;
+	m->curr_elements = mp->curr_elements;
+}
+
+/**
+ * Free the elements that have been allocated since the given mark
+ * of the same pool was taken. Their blocks are kept for reuse by
+ * pool_alloc(). The pool must not have been reused since then.
+ */
+void pool_rewind(Pool_desc *mp, const Pool_mark *m)
+{
+	mp->ring = m->ring;
+	mp->alloc_next = m->alloc_next;
+	mp->alloc_end = m->alloc_end;
+	mp->max_elements = MAX(mp->max_elements, mp->curr_elements);
+	mp->curr_elements = m->curr_elements;
 }
 
 #ifdef POOL_FREE
@@ -225,12 +385,24 @@ void pool_free(Pool_desc *mp, void *e)
  * Note: No Doxygen headers because these function replace functions with
  * the same name defined above. */
 
+/*
+ * Delete the given fake memory pool.
+ */
+void pool_delete(Pool_desc *mp)
+{
+	if (NULL == mp) return;
+	pool_reuse(mp);
+	free(mp);
+}
+
 /*
  * Allocate an element by using malloc() directly.
  */
 void *pool_alloc(Pool_desc *mp)
 {
 	mp->curr_elements++;
+	mp->num_blocks++;
+	mp->bytes += mp->element_size + FLDSIZE_NEXT;
 	assert(!mp->exact || mp->curr_elements <= mp->num_elements,
 	       "Too many elements (%zu>%zu) (pool '%s' created in %s())",
 	       mp->curr_elements, mp->num_elements, mp->name, mp->func);
@@ -252,8 +424,7 @@ void *pool_alloc(Pool_desc *mp)
 void pool_reuse(Pool_desc *mp)
 {
 	if (NULL == mp) return;
-	lgdebug(+D_MEMPOOL, "Used %zu elements (pool '%s' created in %s())\n",
-	        mp->curr_elements, mp->name, mp->func);
+	pool_debug_stats(mp, "Reused");
 
 	/* Free its chained memory blocks. */
 	char *c_next;
@@ -264,6 +435,32 @@ void pool_reuse(Pool_desc *mp)
 	}
 
 	mp->chain = NULL;
+	mp->num_blocks = 0;
+	mp->bytes = 0;
+	mp->max_elements = MAX(mp->max_elements, mp->curr_elements);
+	mp->curr_elements = 0;
+}
+
+void pool_mark(const Pool_desc *mp, Pool_mark *m)
+{
+	m->chain = mp->chain;
+	m->curr_elements = mp->curr_elements;
+}
+
+void pool_rewind(Pool_desc *mp, const Pool_mark *m)
+{
+	char *c_next;
+	for (char *c = mp->chain; c != m->chain; c = c_next)
+	{
+		c_next = POOL_NEXT_BLOCK(c, mp->element_size);
+		free(c);
+		mp->num_blocks--;
+		mp->bytes -= mp->element_size + FLDSIZE_NEXT;
+	}
+
+	mp->chain = m->chain;
+	mp->max_elements = MAX(mp->max_elements, mp->curr_elements);
+	mp->curr_elements = m->curr_elements;
 }
 
 #ifdef POOL_FREE
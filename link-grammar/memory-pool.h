@@ -21,12 +21,29 @@
 
 typedef struct Pool_desc_s Pool_desc;
 
+/* Pool statistics, see pool_get_stats(). */
+typedef lg_pool_stats Pool_stats;
+
+/* A position in a pool, see pool_mark(). */
+typedef struct
+{
+	char *ring;
+	char *alloc_next;
+	char *alloc_end;
+	char *chain;                // Used only by the fake pool allocator.
+	size_t curr_elements;
+} Pool_mark;
+
 /* See below the definition of pool_new(). */
 Pool_desc *pool_new(const char *, const char *, size_t, size_t, bool, bool, bool);
 void *pool_alloc(Pool_desc *) GNUC_MALLOC;
 void pool_reuse(Pool_desc *);
 void pool_delete(Pool_desc *);
 void pool_free(Pool_desc *, void *e);
+void pool_get_stats(const Pool_desc *, Pool_stats *);
+size_t pool_list_get_stats(Pool_desc *const *, size_t, Pool_stats *, size_t);
+void pool_mark(const Pool_desc *, Pool_mark *);
+void pool_rewind(Pool_desc *, const Pool_mark *);
 
 /* Pool allocator debug facility:
  * If configured with "CFLAGS=-DPOOL_ALLOCATOR=0", a fake pool allocator
@@ -38,19 +55,44 @@ void pool_free(Pool_desc *, void *e);
 #define POOL_ALLOCATOR 1
 #endif
 
+/* Blocks grow geometrically, starting with num_elements elements,
+ * up to this block size. */
+#ifndef POOL_MAX_BLOCK_SIZE
+#define POOL_MAX_BLOCK_SIZE (4*1024*1024)
+#endif
+
+/* Blocks of at least this size are advised to use transparent huge
+ * pages (when supported). Define to 0 to disable. */
+#ifndef POOL_HUGE_PAGE_SIZE
+#define POOL_HUGE_PAGE_SIZE (2*1024*1024)
+#endif
+
 #define FLDSIZE_NEXT sizeof(char *) // "next block" field size
 #define POOL_NEXT_BLOCK(blk, offset_next) (*(char **)((blk)+(offset_next)))
 
+/* Header at the start of each block of the real pool allocator. */
+typedef struct
+{
+	char *next;                 // Next block in the chain.
+	size_t data_size;           // Size of element data in this block.
+	size_t block_size;          // Allocated size of this block.
+	bool huge;                  // Advised to use huge pages.
+} Pool_block_header;
+
 struct  Pool_desc_s
 {
 	/* Used only by the real pool allocator. */
 	char *chain;                // Allocated blocks. */
 	char *ring;                 // Current area for allocation.
 	char *alloc_next;           // Next element to be allocated.
+	char *alloc_end;            // End of element data in the current block.
 	char *free_list;            // Allocations that got freed.
-	size_t block_size;          // Block size for pool extension.
-	size_t data_size;           // Size of data inside block_size.
+	size_t header_size;         // Block header size, aligned.
+	size_t next_data_size;      // Data size of the next new block.
 	size_t alignment;           // Alignment of element allocation.
+	size_t num_blocks;          // For stats.
+	size_t num_huge_blocks;     // For stats.
+	size_t bytes;               // For stats.
 
 	/* Common to the real and fake pool allocators. */
 	size_t element_size;        // Allocated memory per element.
@@ -60,6 +102,7 @@ struct  Pool_desc_s
 	/* For debug and stats. */
 	size_t num_elements;
 	size_t curr_elements;
+	size_t max_elements;
 
 	/* Flags that are used by pool_alloc(). */
 	bool zero_out;              // Zero out allocated elements.
@@ -45,8 +45,11 @@ struct count_context_s
 	unsigned int checktimer;  /* Avoid excess system calls */
 	int     table_size;
 	int     log2_table_size;
+	size_t  num_table_entries; /* For stats */
 	Table_connector ** table;
 	Resources current_resources;
+	bool (*cancelled)(void *); /* If non-NULL, abandon the count when true */
+	void *cancel_arg;
 };
 
 static void free_table(count_context_t *ctxt)
@@ -148,6 +151,7 @@ static Table_connector * table_store(count_context_t *ctxt,
 	unsigned int h;
 
 	n = pool_alloc(ctxt->sent->Table_connector_pool);
+	ctxt->num_table_entries++;
 	n->lw = lw; n->rw = rw; n->le = le; n->re = re; n->null_count = null_count;
 	h = pair_hash(ctxt->table_size, lw, rw, le, re, null_count);
 	t = ctxt->table[h];
@@ -183,11 +187,14 @@ find_table_pointer(count_context_t *ctxt,
 	 * checktimer is a device to avoid a gazillion system calls
 	 * to get the timer value. On circa-2017 machines, it results
 	 * in about 0.5-1 timer calls per second.
+	 * A cancelled count (see count_set_cancel()) is abandoned the same way.
 	 */
 	ctxt->checktimer ++;
 	if (ctxt->exhausted || ((0 == ctxt->checktimer%(1<<21)) &&
 	                       (ctxt->current_resources != NULL) &&
-	                       resources_exhausted(ctxt->current_resources)))
+	                       resources_exhausted(ctxt->current_resources)) ||
+	    ((0 == ctxt->checktimer%(1<<12)) && (ctxt->cancelled != NULL) &&
+	     ctxt->cancelled(ctxt->cancel_arg)))
 	{
 		ctxt->exhausted = true;
 		t = table_store(ctxt, lw, rw, le, re, null_count);
@@ -668,6 +675,8 @@ Count_bin do_parse(Sentence sent,
 
 	hist = do_count(ctxt, -1, sent->length, NULL, NULL, null_count+1);
 
+	lgdebug(+5, "Count table entries %zu (null_count %d)\n",
+	        ctxt->num_table_entries, null_count);
 	return hist;
 }
 
@@ -693,6 +702,18 @@ count_context_t * alloc_count_context(Sentence sent)
 	return ctxt;
 }
 
+/**
+ * Set a function that is polled during the count, and abandons it
+ * (like on a timeout) when it returns true. Used for cancelling the
+ * count of a null count which is not needed anymore.
+ */
+void count_set_cancel(count_context_t *ctxt, bool (*cancelled)(void *),
+                      void *arg)
+{
+	ctxt->cancelled = cancelled;
+	ctxt->cancel_arg = arg;
+}
+
 void free_count_context(count_context_t *ctxt, Sentence sent)
 {
 	if (NULL == ctxt) return;
@@ -22,5 +22,6 @@ Count_bin* table_lookup(count_context_t *, int, int, Connector *, Connector *, u
 Count_bin do_parse(Sentence, fast_matcher_t*, count_context_t*, int null_count, Parse_Options);
 
 count_context_t* alloc_count_context(Sentence);
+void count_set_cancel(count_context_t*, bool (*)(void *), void *);
 void free_count_context(count_context_t*, Sentence);
 #endif /* _COUNT_H */
@@ -32,7 +32,7 @@ struct Parse_choice_struct
 	Parse_choice * next;
 	Parse_set * set[2];
 	Link        link[2];   /* the lc fields of these is NULL if there is no link used */
-	Disjunct *ld, *md, *rd;  /* the chosen disjuncts for the relevant three words */
+	Disjunct    *md;       /* the chosen disjunct for the middle word */
 };
 
 struct Parse_set_struct
@@ -97,7 +97,7 @@ static void free_set(Parse_set *s)
 static Parse_choice *
 make_choice(Parse_set *lset, Connector * llc, Connector * lrc,
             Parse_set *rset, Connector * rlc, Connector * rrc,
-            Disjunct *ld, Disjunct *md, Disjunct *rd)
+            Disjunct *md)
 {
 	Parse_choice *pc;
 	pc = (Parse_choice *) xalloc(sizeof(*pc));
@@ -114,9 +114,7 @@ make_choice(Parse_set *lset, Connector * llc, Connector * lrc,
 	pc->link[1].rw = rset->rw;
 	pc->link[1].lc = rlc;
 	pc->link[1].rc = rrc;
-	pc->ld = ld;
 	pc->md = md;
-	pc->rd = rd;
 	return pc;
 }
 
@@ -141,11 +139,11 @@ static void put_choice_in_set(Parse_set *s, Parse_choice *pc)
 static void record_choice(
     Parse_set *lset, Connector * llc, Connector * lrc,
     Parse_set *rset, Connector * rlc, Connector * rrc,
-    Disjunct *ld, Disjunct *md, Disjunct *rd, Parse_set *s)
+    Disjunct *md, Parse_set *s)
 {
 	put_choice_in_set(s, make_choice(lset, llc, lrc,
 	                                 rset, rlc, rrc,
-	                                 ld, md, rd));
+	                                 md));
 }
 
 /**
@@ -319,11 +317,16 @@ static Match_node* sort_matchlist(Match_node* mlist)
  * allocate a memory structures to hold the parse.  This also does
  * a full parse, but it also allocates and fills out the various
  * parse structures.
+ *
+ * Each parse choice records only the disjunct of its middle word, and
+ * not the disjuncts to which le and re belong. This way the resulting
+ * set depends only on its memoizing key, which is needed because
+ * different disjuncts may share le and re (see share_connector_tails()).
  */
 static
 Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
                  count_context_t * ctxt,
-                 Disjunct *ld, Disjunct *rd, int lw, int rw,
+                 int lw, int rw,
                  Connector *le, Connector *re, unsigned int null_count,
                  extractor_t * pex, bool islands_ok)
 {
@@ -382,25 +385,25 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 				if (dis->left == NULL)
 				{
 					pset = mk_parse_set(words, mchxt, ctxt,
-											  dis, NULL, w, rw, dis->right, NULL,
+											  w, rw, dis->right, NULL,
 											  null_count-1, pex, islands_ok);
 					if (pset == NULL) continue;
 					dummy = dummy_set(lw, w, null_count-1, pex);
 					record_choice(dummy, NULL, NULL,
 									  pset,  NULL, NULL,
-									  NULL, NULL, NULL, &xt->set);
+									  dis, &xt->set);
 					RECOUNT({xt->set.recount += pset->recount;})
 				}
 			}
 			pset = mk_parse_set(words, mchxt, ctxt,
-									  NULL, NULL, w, rw, NULL, NULL,
+									  w, rw, NULL, NULL,
 									  null_count-1, pex, islands_ok);
 			if (pset != NULL)
 			{
 				dummy = dummy_set(lw, w, null_count-1, pex);
 				record_choice(dummy, NULL, NULL,
 								  pset,  NULL, NULL,
-								  NULL, NULL, NULL, &xt->set);
+								  NULL, &xt->set);
 				RECOUNT({xt->set.recount += pset->recount;})
 			}
 		}
@@ -460,44 +463,44 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 				if (Lmatch)
 				{
 					ls[0] = mk_parse_set(words, mchxt, ctxt,
-					             ld, d, lw, w, le->next, d->left->next,
+					             lw, w, le->next, d->left->next,
 					             lnull_count, pex, islands_ok);
 
 					if (le->multi)
 						ls[1] = mk_parse_set(words, mchxt, ctxt,
-						              ld, d, lw, w, le, d->left->next,
+						              lw, w, le, d->left->next,
 						              lnull_count, pex, islands_ok);
 
 					if (d->left->multi)
 						ls[2] = mk_parse_set(words, mchxt, ctxt,
-						              ld, d, lw, w, le->next, d->left,
+						              lw, w, le->next, d->left,
 						              lnull_count, pex, islands_ok);
 
 					if (le->multi && d->left->multi)
 						ls[3] = mk_parse_set(words, mchxt, ctxt,
-						              ld, d, lw, w, le, d->left,
+						              lw, w, le, d->left,
 						              lnull_count, pex, islands_ok);
 				}
 
 				if (Rmatch)
 				{
 					rs[0] = mk_parse_set(words, mchxt, ctxt,
-					                 d, rd, w, rw, d->right->next, re->next,
+					                 w, rw, d->right->next, re->next,
 					                 rnull_count, pex, islands_ok);
 
 					if (d->right->multi)
 						rs[1] = mk_parse_set(words, mchxt, ctxt,
-					                 d, rd, w, rw, d->right, re->next,
+					                 w, rw, d->right, re->next,
 						              rnull_count, pex, islands_ok);
 
 					if (re->multi)
 						rs[2] = mk_parse_set(words, mchxt, ctxt,
-						              d, rd, w, rw, d->right->next, re,
+						              w, rw, d->right->next, re,
 						              rnull_count, pex, islands_ok);
 
 					if (d->right->multi && re->multi)
 						rs[3] = mk_parse_set(words, mchxt, ctxt,
-						              d, rd, w, rw, d->right, re,
+						              w, rw, d->right, re,
 						              rnull_count, pex, islands_ok);
 				}
 
@@ -511,7 +514,7 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 						if (rs[j] == NULL) continue;
 						record_choice(ls[i], le, d->left,
 						              rs[j], d->right, re,
-						              ld, d, rd, &xt->set);
+						              d, &xt->set);
 						RECOUNT({xt->set.recount += ls[i]->recount * rs[j]->recount;})
 					}
 				}
@@ -520,7 +523,7 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 				{
 					/* Evaluate using the left match, but not the right */
 					Parse_set* rset = mk_parse_set(words, mchxt, ctxt,
-					                        d, rd, w, rw, d->right, re,
+					                        w, rw, d->right, re,
 					                        rnull_count, pex, islands_ok);
 					if (rset != NULL)
 					{
@@ -532,7 +535,7 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 							record_choice(ls[i], le, d->left,
 							              rset,  NULL /* d->right */,
 							              re,  /* the NULL indicates no link*/
-							              ld, d, rd, &xt->set);
+							              d, &xt->set);
 							RECOUNT({xt->set.recount += ls[i]->recount * rset->recount;})
 						}
 					}
@@ -542,7 +545,7 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 				{
 					/* Evaluate using the right match, but not the left */
 					Parse_set* lset = mk_parse_set(words, mchxt, ctxt,
-					                        ld, d, lw, w, le, d->left,
+					                        lw, w, le, d->left,
 					                        lnull_count, pex, islands_ok);
 
 					if (lset != NULL)
@@ -555,7 +558,7 @@ Parse_set * mk_parse_set(Word* words, fast_matcher_t *mchxt,
 							record_choice(lset, NULL /* le */,
 							                    d->left,  /* NULL indicates no link */
 							              rs[j], d->right, re,
-							              ld, d, rd, &xt->set);
+							              d, &xt->set);
 							RECOUNT({xt->set.recount += lset->recount * rs[j]->recount;})
 						}
 					}
@@ -623,7 +626,7 @@ bool build_parse_set(extractor_t* pex, Sentence sent,
 {
 	pex->parse_set =
 		mk_parse_set(sent->word, mchxt, ctxt,
-		             NULL, NULL, -1, sent->length, NULL, NULL, null_count+1,
+		             -1, sent->length, NULL, NULL, null_count+1,
 		             pex, opts->islands_ok);
 
 
@@ -640,23 +643,34 @@ void check_link_size(Linkage lkg)
 	}
 }
 
-static void issue_link(Linkage lkg, Disjunct * ld, Disjunct * rd, Link * link)
+static void issue_link(Linkage lkg, Link * link)
 {
 	check_link_size(lkg);
 	lkg->link_array[lkg->num_links] = *link;
 	lkg->num_links++;
-
-	lkg->chosen_disjuncts[link->lw] = ld;
-	lkg->chosen_disjuncts[link->rw] = rd;
 }
 
+/**
+ * Issue the links of the given choice, and record the disjunct of its
+ * middle word. The disjuncts of the other end of these links are
+ * recorded by the choices in which they are the middle word.
+ * A choice of an island word (which has no left links) is recorded
+ * only if its disjunct has right links.
+ */
 static void issue_links_for_choice(Linkage lkg, Parse_choice *pc)
 {
 	if (pc->link[0].lc != NULL) { /* there is a link to generate */
-		issue_link(lkg, pc->ld, pc->md, &pc->link[0]);
+		issue_link(lkg, &pc->link[0]);
+		lkg->chosen_disjuncts[pc->link[0].rw] = pc->md;
 	}
 	if (pc->link[1].lc != NULL) {
-		issue_link(lkg, pc->md, pc->rd, &pc->link[1]);
+		issue_link(lkg, &pc->link[1]);
+		lkg->chosen_disjuncts[pc->link[1].lw] = pc->md;
+	}
+	if ((pc->md != NULL) && (pc->md->left == NULL) && (pc->md->right != NULL))
+	{
+		/* An island word; its disjunct has only right links. */
+		lkg->chosen_disjuncts[pc->set[1]->lw] = pc->md;
 	}
 }
 
@@ -105,70 +105,6 @@ void free_fast_matcher(Sentence sent, fast_matcher_t *mchxt)
 	xfree(mchxt, sizeof(fast_matcher_t));
 }
 
-/**
- * Adds the match node m to the sorted list of match nodes l.
- * Makes the list sorted from smallest to largest.
- */
-static Match_node * add_to_right_table_list(Match_node * m, Match_node * l)
-{
-	Match_node *p, *prev;
-
-	if (l == NULL) return m;
-
-	/* Insert m at head of list */
-	if ((m->d->right->nearest_word) <= (l->d->right->nearest_word))
-	{
-		m->next = l;
-		return m;
-	}
-
-	/* Walk list to insertion point */
-	prev = l;
-	p = prev->next;
-	while (p != NULL && ((m->d->right->nearest_word) > (p->d->right->nearest_word)))
-	{
-		prev = p;
-		p = p->next;
-	}
-
-	m->next = p;
-	prev->next = m;
-
-	return l;  /* return pointer to original head */
-}
-
-/**
- * Adds the match node m to the sorted list of match nodes l.
- * Makes the list sorted from largest to smallest
- */
-static Match_node * add_to_left_table_list(Match_node * m, Match_node * l)
-{
-	Match_node *p, *prev;
-
-	if (l == NULL) return m;
-
-	/* Insert m at head of list */
-	if ((m->d->left->nearest_word) >= (l->d->left->nearest_word))
-	{
-		m->next = l;
-		return m;
-	}
-
-	/* Walk list to insertion point */
-	prev = l;
-	p = prev->next;
-	while (p != NULL && ((m->d->left->nearest_word) < (p->d->left->nearest_word)))
-	{
-		prev = p;
-		p = p->next;
-	}
-
-	m->next = p;
-	prev->next = m;
-
-	return l;  /* return pointer to original head */
-}
-
 /**
  * Compare only the uppercase part of two connectors.
  * Return true if they are the same, else false.
@@ -216,29 +152,59 @@ static Match_node **get_match_table_entry(unsigned int size, Match_node **t,
 }
 
 /**
- * The disjunct d (whose left or right pointer points to c) is put
- * into the appropriate hash table
- * dir =  1, we're putting this into a right table.
- * dir = -1, we're putting this into a left table.
+ * Put the disjuncts of the list dl that have connectors in direction
+ * dir into the hash table t.
+ * dir =  1, we're putting them into a right table.
+ * dir = -1, we're putting them into a left table.
+ *
+ * Each bucket list is sorted by the nearest_word of the first connector
+ * of its disjuncts, from the nearest to the farthest (i.e. from smallest
+ * to largest in a right table), so that form_match_list() can stop at
+ * the first one which is too far. Disjuncts of an equal nearest_word
+ * are in the reverse order of dl. This is done by a distribution sort:
+ * The disjuncts are first gathered by nearest_word, and then appended
+ * to their buckets in nearest_word order, so it takes a linear time
+ * even for words with many disjuncts of the same first connector.
+ * by_nw and tail are scratch arrays of the sentence length and of the
+ * table size.
  */
 static void put_into_match_table(Sentence sent, unsigned int size,
-                                 Match_node ** t, Disjunct * d,
-                                 Connector * c, int dir)
+                                 Match_node ** t, Disjunct * dl, int dir,
+                                 Match_node ** by_nw, Match_node ** tail)
 {
-	Match_node *m, **xl;
+	size_t len = sent->length;
 
-	m = pool_alloc(sent->fm_Match_node);
-	m->next = NULL;
-	m->d = d;
+	memset(by_nw, 0, len * sizeof(Match_node *));
+	for (Disjunct *d = dl; d != NULL; d = d->next)
+	{
+		Connector *c = (dir == 1) ? d->right : d->left;
+		if (c == NULL) continue;
 
-	xl = get_match_table_entry(size, t, c, dir);
-	assert(NULL != xl, "get_match_table_entry: Overflow");
-	if (dir == 1) {
-		*xl = add_to_right_table_list(m, *xl);
+		Match_node *m = pool_alloc(sent->fm_Match_node);
+		m->d = d;
+		m->next = by_nw[c->nearest_word];
+		by_nw[c->nearest_word] = m;
 	}
-	else
+
+	for (size_t i = 0; i < len; i++)
 	{
-		*xl = add_to_left_table_list(m, *xl);
+		size_t nw = (dir == 1) ? i : len - 1 - i;
+		Match_node *next;
+
+		for (Match_node *m = by_nw[nw]; m != NULL; m = next)
+		{
+			Connector *c = (dir == 1) ? m->d->right : m->d->left;
+			Match_node **xl = get_match_table_entry(size, t, c, dir);
+			assert(NULL != xl, "get_match_table_entry: Overflow");
+
+			next = m->next;
+			m->next = NULL;
+			if (NULL == *xl)
+				*xl = m;
+			else
+				tail[xl - t]->next = m;
+			tail[xl - t] = m;
+		}
 	}
 }
 
@@ -248,7 +214,6 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent)
 	size_t w;
 	size_t len;
 	Match_node ** t;
-	Disjunct * d;
 	fast_matcher_t *ctxt;
 
 	ctxt = (fast_matcher_t *) xalloc(sizeof(fast_matcher_t));
@@ -275,6 +240,10 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent)
 			         /*zero_out*/false, /*align*/true, /*exact*/false);
 	}
 
+	size_t max_size = next_power_of_two_up(sent->dict->contable.num_con);
+	Match_node **by_nw = malloc(sent->length * sizeof(Match_node *));
+	Match_node **tail = malloc(max_size * sizeof(Match_node *));
+
 	for (w=0; w<sent->length; w++)
 	{
 		len = left_disjunct_list_length(sent->word[w].d);
@@ -283,15 +252,7 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent)
 		ctxt->l_table_size[w] = size;
 		t = ctxt->l_table[w] = (Match_node **) xalloc(size * sizeof(Match_node *));
 		memset(t, 0, size * sizeof(Match_node *));
-
-		for (d = sent->word[w].d; d != NULL; d = d->next)
-		{
-			if (d->left != NULL)
-			{
-				//printf("%s %d\n", connector_string(d->left), d->left->length_limit);
-				put_into_match_table(sent, size, t, d, d->left, -1);
-			}
-		}
+		put_into_match_table(sent, size, t, sent->word[w].d, -1, by_nw, tail);
 
 		len = right_disjunct_list_length(sent->word[w].d);
 		len = MIN(sent->dict->contable.num_con, len);
@@ -299,17 +260,11 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent)
 		ctxt->r_table_size[w] = size;
 		t = ctxt->r_table[w] = (Match_node **) xalloc(size * sizeof(Match_node *));
 		memset(t, 0, size * sizeof(Match_node *));
-
-		for (d = sent->word[w].d; d != NULL; d = d->next)
-		{
-			if (d->right != NULL)
-			{
-				//printf("%s %d\n", connector_string(d->right), d->right->length_limit);
-				put_into_match_table(sent, size, t, d, d->right, 1);
-			}
-		}
+		put_into_match_table(sent, size, t, sent->word[w].d, 1, by_nw, tail);
 	}
 
+	free(by_nw);
+	free(tail);
 	return ctxt;
 }
 
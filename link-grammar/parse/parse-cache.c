@@ -0,0 +1,777 @@
+/*************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                      */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <ctype.h>
+#include <string.h>
+
+#include "api-structures.h"
+#include "connectors.h"
+#include "dict-common/dict-common.h"   // For Dictionary_s
+#include "disjunct-utils.h"
+#include "linkage/linkage.h"
+#include "parse-cache.h"
+#include "string-set.h"
+#include "tokenize/tok-structures.h"   // For Gword_struct
+#include "utilities.h"
+
+/* A cache of parse results, for sentences that are parsed repeatedly.
+ *
+ * The cache belongs to the dictionary, and its entries are keyed by the
+ * sentence text (with its whitespace normalized) together with the
+ * parse options that can change the results. It is used only when the
+ * "result_cache" parse option is not 0, and its total memory is then
+ * bounded by this option (in kilobytes), by evicting the least recently
+ * used entries.
+ *
+ * An entry holds a copy of the linkages of the sentence, along with
+ * their chosen disjuncts and connectors, which is independent of the
+ * sentence: The disjuncts and connectors are in arrays of their own,
+ * and the wordgraph words (in the disjunct gword sets and the linkage
+ * wordgraph paths) are recorded by their node_num. On a hit, the
+ * linkages are copied into the new sentence, and these words are
+ * mapped to the words of its wordgraph. The tokenization of the same
+ * text is deterministic, but as a safety measure, the entry is used
+ * only if the wordgraph words of the new sentence have the same
+ * subwords as those of the cached one.
+ *
+ * Only the classic parser results are cached. Results that depend on
+ * random choices (when the linkages are sampled and the random numbers
+ * are not repeatable), as well as those of a parse that has exhausted
+ * its resources, are not cached.
+ *
+ * The cache is protected by a spinlock of the dictionary (see
+ * utilities.h, which also has the fallbacks for builds without atomics),
+ * which is held while an entry is copied into a sentence. */
+
+typedef struct cache_entry_s cache_entry;
+struct cache_entry_s
+{
+	cache_entry *next;             /* Hash table bucket chain */
+	cache_entry *lru_prev;         /* LRU list, most recently used first */
+	cache_entry *lru_next;
+	unsigned int hash;
+	char *key;
+	size_t size;                   /* Approximate memory size */
+
+	/* The parse results of the sentence */
+	int num_linkages_found;
+	size_t num_linkages_post_processed;
+	size_t num_valid_linkages;
+	size_t null_count;
+	size_t num_linkages;           /* sent->num_linkages_alloced */
+	struct Linkage_s *lkg;         /* Pointers are into this entry */
+	size_t *wg_path;               /* Linkage wordgraph paths in gwidx[] */
+
+	/* The chosen disjuncts of all the linkages, and their connectors */
+	Disjunct *dj;
+	size_t num_dj;
+	Connector *cn;
+	size_t num_cn;
+	size_t *dj_gset;               /* Disjunct gword sets in gwidx[] */
+
+	/* Runs of wordgraph word node_nums: a length, then the node_nums */
+	size_t *gwidx;
+	size_t num_gwidx;
+
+	/* The subwords of the wordgraph words, by their node_num */
+	const char **subword;
+	size_t num_gwords;
+
+	String_set *string_set;        /* Disjunct words and link names */
+};
+
+struct parse_cache_s
+{
+	cache_entry **table;
+	size_t table_size;             /* A power of 2 */
+	size_t num_entries;
+	cache_entry *lru_head;
+	cache_entry *lru_tail;
+	size_t size;                   /* Total size of the entries */
+
+	/* Statistics */
+	size_t lookups;
+	size_t hits;
+	size_t evictions;
+};
+
+#define PARSE_CACHE_INIT_SIZE 256
+
+/* ======================================================== */
+
+/**
+ * Return the cache key of the sentence: Its text, with each whitespace
+ * sequence replaced by a single blank and no leading or trailing
+ * whitespace, followed by the values of the parse options that may
+ * change the parse results.
+ */
+static char *cache_key(Sentence sent, Parse_Options opts)
+{
+#define OPTS_KEY_SIZE 256
+	char *key = malloc(strlen(sent->orig_sentence) + OPTS_KEY_SIZE);
+	char *k = key;
+	bool blank = false;
+
+	for (const char *p = sent->orig_sentence; '\0' != *p; p++)
+	{
+		if (isspace((unsigned char)*p))
+		{
+			blank = true;
+			continue;
+		}
+		if (blank && (k != key)) *k++ = ' ';
+		blank = false;
+		*k++ = *p;
+	}
+
+	/* The newline cannot appear in the normalized sentence. */
+	snprintf(k, OPTS_KEY_SIZE,
+	         "\n%.17g %d %d %d %d %d %zu %d %d %d %zu %d %zu %d",
+	         opts->disjunct_cost, opts->disjunct_budget,
+	         opts->min_null_count, opts->max_null_count, opts->islands_ok,
+	         opts->use_cluster_disjuncts, opts->short_length, opts->all_short,
+	         opts->repeatable_rand, opts->perform_pp_prune,
+	         opts->twopass_length, (int)opts->cost_model.type,
+	         opts->linkage_limit, opts->use_spell_guess);
+
+	return key;
+#undef OPTS_KEY_SIZE
+}
+
+/* FNV-1a */
+static unsigned int key_hash(const char *key)
+{
+	unsigned int h = 2166136261U;
+
+	for (; '\0' != *key; key++)
+	{
+		h ^= (unsigned char)*key;
+		h *= 16777619U;
+	}
+	return h;
+}
+
+/* ======================================================== */
+/* Copying the sentence results into a cache entry. */
+
+static void entry_delete(cache_entry *e)
+{
+	if (NULL == e) return;
+
+	for (size_t i = 0; i < e->num_linkages; i++)
+	{
+		free(e->lkg[i].link_array);
+		free(e->lkg[i].chosen_disjuncts);
+	}
+	free(e->lkg);
+	free(e->wg_path);
+	free(e->dj);
+	free(e->cn);
+	free(e->dj_gset);
+	free(e->gwidx);
+	free(e->subword);
+	free(e->key);
+	string_set_delete(e->string_set);
+	free(e);
+}
+
+static size_t connector_list_len(const Connector *c)
+{
+	size_t n = 0;
+	for (; NULL != c; c = c->next) n++;
+	return n;
+}
+
+static size_t gword_set_len(const gword_set *gs)
+{
+	size_t n = 0;
+	for (; NULL != gs; gs = gs->next) n++;
+	return n;
+}
+
+static size_t gword_path_len(Gword **path)
+{
+	size_t n = 0;
+	if (NULL == path) return 0;
+	for (; NULL != path[n]; n++)
+		;
+	return n;
+}
+
+#define NO_GWORD ((size_t)-1)
+
+/**
+ * Return the node_num of the wordgraph word w, or NO_GWORD if it is not
+ * one of the words of \p gwv.
+ */
+static size_t gword_index(Gword **gwv, size_t num_gwords, const Gword *w)
+{
+	if ((NULL == w) || (w->node_num >= num_gwords)) return NO_GWORD;
+	if (gwv[w->node_num] != w) return NO_GWORD;
+	return w->node_num;
+}
+
+/**
+ * Copy the connector list c to \p cn, and return the copy.
+ */
+static Connector *copy_connector_list(const Connector *c, Connector **cn)
+{
+	Connector *head = NULL;
+	Connector **tail = &head;
+
+	for (; NULL != c; c = c->next)
+	{
+		Connector *nc = (*cn)++;
+		*nc = *c;
+		nc->originating_gword = NULL;
+		*tail = nc;
+		tail = &nc->next;
+	}
+	*tail = NULL;
+
+	return head;
+}
+
+/**
+ * Return the connector in \p copy that corresponds to connector c of
+ * \p list (which is a copy of \p list), or NULL if c is not in it.
+ */
+static Connector *corresponding_connector(const Connector *list,
+                                          Connector *copy, const Connector *c)
+{
+	for (; NULL != list; list = list->next, copy = copy->next)
+		if (list == c) return copy;
+	return NULL;
+}
+
+static Connector *link_connector(const Disjunct *d, const Disjunct *nd,
+                                 const Connector *c)
+{
+	if (NULL == d) return NULL;
+
+	Connector *nc = corresponding_connector(d->right, nd->right, c);
+	if (NULL == nc) nc = corresponding_connector(d->left, nd->left, c);
+	return nc;
+}
+
+/**
+ * Create a cache entry with a copy of the parse results of the sentence.
+ * Return NULL if they cannot be copied.
+ */
+static cache_entry *entry_new(Sentence sent)
+{
+	size_t num_gwords = 0;
+	size_t num_dj = 0;
+	size_t num_cn = 0;
+	size_t num_gwidx = 0;
+	size_t num_linkages = sent->num_linkages_alloced;
+
+	for (Gword *w = sent->wordgraph; NULL != w; w = w->chain_next)
+		num_gwords++;
+
+	Gword **gwv = malloc(num_gwords * sizeof(Gword *));
+	size_t i = 0;
+	for (Gword *w = sent->wordgraph; NULL != w; w = w->chain_next, i++)
+	{
+		if (w->node_num != i)
+		{
+			free(gwv);
+			return NULL;
+		}
+		gwv[i] = w;
+	}
+
+	for (i = 0; i < num_linkages; i++)
+	{
+		Linkage lkg = &sent->lnkages[i];
+
+		for (WordIdx w = 0; w < lkg->num_words; w++)
+		{
+			Disjunct *d = lkg->chosen_disjuncts[w];
+			if (NULL == d) continue;
+			num_dj++;
+			num_cn += connector_list_len(d->left) + connector_list_len(d->right);
+			num_gwidx += 1 + gword_set_len(d->originating_gword);
+		}
+		num_gwidx += 1 + gword_path_len(lkg->wg_path);
+	}
+
+	cache_entry *e = malloc(sizeof(cache_entry));
+	memset(e, 0, sizeof(cache_entry));
+
+	e->num_linkages_found = sent->num_linkages_found;
+	e->num_linkages_post_processed = sent->num_linkages_post_processed;
+	e->num_valid_linkages = sent->num_valid_linkages;
+	e->null_count = sent->null_count;
+	e->num_linkages = num_linkages;
+	e->num_dj = num_dj;
+	e->num_cn = num_cn;
+	e->num_gwidx = num_gwidx;
+	e->num_gwords = num_gwords;
+
+	e->lkg = malloc(num_linkages * sizeof(struct Linkage_s));
+	memset(e->lkg, 0, num_linkages * sizeof(struct Linkage_s));
+	e->wg_path = malloc(num_linkages * sizeof(size_t));
+	e->dj = malloc(num_dj * sizeof(Disjunct));
+	e->cn = malloc(num_cn * sizeof(Connector));
+	e->dj_gset = malloc(num_dj * sizeof(size_t));
+	e->gwidx = malloc(num_gwidx * sizeof(size_t));
+	e->subword = malloc(num_gwords * sizeof(const char *));
+	e->string_set = string_set_create();
+
+	size_t size = sizeof(cache_entry) +
+		num_linkages * (sizeof(struct Linkage_s) + sizeof(size_t)) +
+		num_dj * (sizeof(Disjunct) + sizeof(size_t)) +
+		num_cn * sizeof(Connector) +
+		num_gwidx * sizeof(size_t) +
+		num_gwords * sizeof(const char *);
+
+	for (i = 0; i < num_gwords; i++)
+	{
+		e->subword[i] = string_set_add(gwv[i]->subword, e->string_set);
+		size += strlen(gwv[i]->subword) + 1;
+	}
+
+	Disjunct *nd = e->dj;
+	Connector *cn = e->cn;
+	size_t *gwidx = e->gwidx;
+
+	for (i = 0; i < num_linkages; i++)
+	{
+		Linkage lkg = &sent->lnkages[i];
+		Linkage nlkg = &e->lkg[i];
+
+		*nlkg = *lkg;
+		nlkg->word = NULL;
+		nlkg->disjunct_list_str = NULL;
+#ifdef USE_CORPUS
+		nlkg->sense_list = NULL;
+#endif
+		nlkg->wg_path = NULL;
+		nlkg->wg_path_display = NULL;
+		nlkg->pp_domains = NULL;
+		nlkg->sent = NULL;
+		nlkg->cdsz = lkg->num_words;
+		nlkg->chosen_disjuncts = malloc(lkg->num_words * sizeof(Disjunct *));
+		nlkg->link_array = malloc(lkg->lasz * sizeof(Link));
+		memset(nlkg->link_array, 0, lkg->lasz * sizeof(Link));
+		size += lkg->num_words * sizeof(Disjunct *) + lkg->lasz * sizeof(Link);
+
+		for (WordIdx w = 0; w < lkg->num_words; w++)
+		{
+			Disjunct *d = lkg->chosen_disjuncts[w];
+
+			if (NULL == d)
+			{
+				nlkg->chosen_disjuncts[w] = NULL;
+				continue;
+			}
+
+			*nd = *d;
+			nd->next = NULL;
+			nd->left = copy_connector_list(d->left, &cn);
+			nd->right = copy_connector_list(d->right, &cn);
+			nd->originating_gword = NULL;
+			nd->word_string = string_set_add(d->word_string, e->string_set);
+
+			e->dj_gset[nd - e->dj] = gwidx - e->gwidx;
+			*gwidx++ = gword_set_len(d->originating_gword);
+			for (gword_set *gs = d->originating_gword; NULL != gs; gs = gs->next)
+			{
+				size_t gi = gword_index(gwv, num_gwords, gs->o_gword);
+				if (NO_GWORD == gi) goto failure;
+				*gwidx++ = gi;
+			}
+
+			nlkg->chosen_disjuncts[w] = nd++;
+		}
+
+		for (size_t l = 0; l < lkg->num_links; l++)
+		{
+			Link *lnk = &lkg->link_array[l];
+			Link *nlnk = &nlkg->link_array[l];
+
+			*nlnk = *lnk;
+			nlnk->lc = link_connector(lkg->chosen_disjuncts[lnk->lw],
+			                          nlkg->chosen_disjuncts[lnk->lw], lnk->lc);
+			nlnk->rc = link_connector(lkg->chosen_disjuncts[lnk->rw],
+			                          nlkg->chosen_disjuncts[lnk->rw], lnk->rc);
+			if ((NULL == nlnk->lc) || (NULL == nlnk->rc)) goto failure;
+			if (NULL != lnk->link_name)
+			{
+				nlnk->link_name = string_set_add(lnk->link_name, e->string_set);
+				size += strlen(lnk->link_name) + 1;
+			}
+		}
+
+		e->wg_path[i] = gwidx - e->gwidx;
+		*gwidx++ = gword_path_len(lkg->wg_path);
+		for (Gword **p = lkg->wg_path; (NULL != p) && (NULL != *p); p++)
+		{
+			size_t gi = gword_index(gwv, num_gwords, *p);
+			if (NO_GWORD == gi) goto failure;
+			*gwidx++ = gi;
+		}
+	}
+
+	e->size = size;
+	free(gwv);
+	return e;
+
+failure:
+	free(gwv);
+	entry_delete(e);
+	return NULL;
+}
+
+/* ======================================================== */
+/* Copying a cache entry into a sentence. */
+
+static gword_set *restore_gword_set(const size_t *run, Gword **gwv)
+{
+	size_t len = run[0];
+
+	if (0 == len) return NULL;
+	if (1 == len) return &gwv[run[1]]->gword_set_head;
+
+	/* gword_set_add() prepends - add the elements in reverse order. */
+	gword_set *gs = NULL;
+	for (size_t i = len; i > 0; i--)
+		gs = gword_set_add(gs, &gwv[run[i]]->gword_set_head);
+	return gs;
+}
+
+/**
+ * Copy the parse results of the cache entry into the sentence.
+ * Return false if the entry doesn't fit the sentence wordgraph.
+ */
+static bool entry_restore(const cache_entry *e, Sentence sent)
+{
+	Gword **gwv = malloc(e->num_gwords * sizeof(Gword *));
+	size_t i = 0;
+
+	for (Gword *w = sent->wordgraph; NULL != w; w = w->chain_next, i++)
+	{
+		if ((i >= e->num_gwords) || (w->node_num != i) ||
+		    (0 != strcmp(w->subword, e->subword[i])))
+		{
+			free(gwv);
+			return false;
+		}
+		gwv[i] = w;
+	}
+	if (i != e->num_gwords)
+	{
+		free(gwv);
+		return false;
+	}
+
+	/* The disjuncts and connectors go to the sentence memory block. */
+	size_t dsize = ALIGN(e->num_dj * sizeof(Disjunct), CACHE_LINE_SIZE);
+	size_t csize = ALIGN(e->num_cn * sizeof(Connector), CACHE_LINE_SIZE);
+	size_t memblock_sz = MAX(dsize + csize, CACHE_LINE_SIZE);
+	void *memblock = aligned_alloc(CACHE_LINE_SIZE, memblock_sz);
+	Disjunct *dj = memblock;
+	Connector *cn = (Connector *)((char *)memblock + dsize);
+
+	free_sentence_disjuncts(sent);
+	sent->disjuncts_connectors_memblock = memblock;
+	sent->disjuncts_connectors_memblock_sz = memblock_sz;
+
+#define RELOC(p, base, nbase) ((NULL == (p)) ? NULL : (nbase) + ((p) - (base)))
+	memcpy(cn, e->cn, e->num_cn * sizeof(Connector));
+	for (i = 0; i < e->num_cn; i++)
+		cn[i].next = RELOC(e->cn[i].next, e->cn, cn);
+
+	for (i = 0; i < e->num_dj; i++)
+	{
+		Disjunct *d = &dj[i];
+
+		*d = e->dj[i];
+		d->left = RELOC(e->dj[i].left, e->cn, cn);
+		d->right = RELOC(e->dj[i].right, e->cn, cn);
+		d->word_string = string_set_add(d->word_string, sent->string_set);
+		d->originating_gword = restore_gword_set(&e->gwidx[e->dj_gset[i]], gwv);
+
+		for (Connector *c = d->left; NULL != c; c = c->next)
+			c->originating_gword = d->originating_gword;
+		for (Connector *c = d->right; NULL != c; c = c->next)
+			c->originating_gword = d->originating_gword;
+	}
+
+	free_linkages(sent);
+	sent->lnkages = malloc(e->num_linkages * sizeof(struct Linkage_s));
+
+	for (i = 0; i < e->num_linkages; i++)
+	{
+		const struct Linkage_s *elkg = &e->lkg[i];
+		Linkage lkg = &sent->lnkages[i];
+
+		*lkg = *elkg;
+		lkg->sent = sent;
+
+		lkg->chosen_disjuncts = exalloc(lkg->num_words * sizeof(Disjunct *));
+		for (WordIdx w = 0; w < lkg->num_words; w++)
+			lkg->chosen_disjuncts[w] = RELOC(elkg->chosen_disjuncts[w], e->dj, dj);
+
+		lkg->link_array = malloc(lkg->lasz * sizeof(Link));
+		memcpy(lkg->link_array, elkg->link_array, lkg->lasz * sizeof(Link));
+		for (size_t l = 0; l < lkg->num_links; l++)
+		{
+			Link *lnk = &lkg->link_array[l];
+
+			lnk->lc = RELOC(lnk->lc, e->cn, cn);
+			lnk->rc = RELOC(lnk->rc, e->cn, cn);
+			if (NULL != lnk->link_name)
+				lnk->link_name = string_set_add(lnk->link_name, sent->string_set);
+		}
+
+		const size_t *run = &e->gwidx[e->wg_path[i]];
+		lkg->wg_path = malloc((run[0] + 1) * sizeof(Gword *));
+		for (size_t p = 0; p < run[0]; p++)
+			lkg->wg_path[p] = gwv[run[p+1]];
+		lkg->wg_path[run[0]] = NULL;
+	}
+#undef RELOC
+
+	sent->num_linkages_found = e->num_linkages_found;
+	sent->num_linkages_alloced = e->num_linkages;
+	sent->num_linkages_post_processed = e->num_linkages_post_processed;
+	sent->num_valid_linkages = e->num_valid_linkages;
+	sent->null_count = e->null_count;
+
+	free(gwv);
+	return true;
+}
+
+/* ======================================================== */
+/* The hash table and the LRU list. These functions are called with
+ * the cache lock held. */
+
+static parse_cache *parse_cache_new(void)
+{
+	parse_cache *pc = malloc(sizeof(parse_cache));
+	memset(pc, 0, sizeof(parse_cache));
+
+	pc->table_size = PARSE_CACHE_INIT_SIZE;
+	pc->table = malloc(pc->table_size * sizeof(cache_entry *));
+	memset(pc->table, 0, pc->table_size * sizeof(cache_entry *));
+
+	return pc;
+}
+
+static cache_entry *cache_find(parse_cache *pc, const char *key,
+                               unsigned int h)
+{
+	for (cache_entry *e = pc->table[h & (pc->table_size-1)]; NULL != e;
+	     e = e->next)
+	{
+		if ((e->hash == h) && (0 == strcmp(e->key, key))) return e;
+	}
+	return NULL;
+}
+
+static void lru_unlink(parse_cache *pc, cache_entry *e)
+{
+	if (NULL != e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+	else pc->lru_head = e->lru_next;
+	if (NULL != e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+	else pc->lru_tail = e->lru_prev;
+}
+
+static void lru_push(parse_cache *pc, cache_entry *e)
+{
+	e->lru_prev = NULL;
+	e->lru_next = pc->lru_head;
+	if (NULL != pc->lru_head) pc->lru_head->lru_prev = e;
+	else pc->lru_tail = e;
+	pc->lru_head = e;
+}
+
+static void cache_grow(parse_cache *pc)
+{
+	size_t new_size = 2 * pc->table_size;
+	cache_entry **new_table = malloc(new_size * sizeof(cache_entry *));
+	memset(new_table, 0, new_size * sizeof(cache_entry *));
+
+	for (size_t i = 0; i < pc->table_size; i++)
+	{
+		cache_entry *next;
+		for (cache_entry *e = pc->table[i]; NULL != e; e = next)
+		{
+			next = e->next;
+			e->next = new_table[e->hash & (new_size-1)];
+			new_table[e->hash & (new_size-1)] = e;
+		}
+	}
+
+	free(pc->table);
+	pc->table = new_table;
+	pc->table_size = new_size;
+}
+
+static void cache_remove(parse_cache *pc, cache_entry *e)
+{
+	cache_entry **ep = &pc->table[e->hash & (pc->table_size-1)];
+
+	while (*ep != e) ep = &(*ep)->next;
+	*ep = e->next;
+	lru_unlink(pc, e);
+	pc->num_entries--;
+	pc->size -= e->size;
+	entry_delete(e);
+}
+
+static void cache_add(parse_cache *pc, cache_entry *e, size_t max_size)
+{
+	if (pc->num_entries >= pc->table_size) cache_grow(pc);
+
+	cache_entry **bucket = &pc->table[e->hash & (pc->table_size-1)];
+	e->next = *bucket;
+	*bucket = e;
+	lru_push(pc, e);
+	pc->num_entries++;
+	pc->size += e->size;
+
+	while ((pc->size > max_size) && (pc->lru_tail != e))
+	{
+		cache_remove(pc, pc->lru_tail);
+		pc->evictions++;
+	}
+}
+
+/* ======================================================== */
+
+/**
+ * If the parse results of the sentence are in the cache of its
+ * dictionary, copy them into the sentence and return true.
+ */
+bool parse_cache_lookup(Sentence sent, Parse_Options opts)
+{
+	Dictionary dict = sent->dict;
+	bool found = false;
+
+	if (0 == opts->result_cache) return false;
+
+	char *key = cache_key(sent, opts);
+	unsigned int h = key_hash(key);
+
+	spin_lock(&dict->parse_cache_lock);
+	if (NULL == dict->parse_cache) dict->parse_cache = parse_cache_new();
+	parse_cache *pc = dict->parse_cache;
+
+	pc->lookups++;
+	cache_entry *e = cache_find(pc, key, h);
+	if ((NULL != e) && entry_restore(e, sent))
+	{
+		lru_unlink(pc, e);
+		lru_push(pc, e);
+		pc->hits++;
+		found = true;
+	}
+	spin_unlock(&dict->parse_cache_lock);
+
+	free(key);
+	return found;
+}
+
+/**
+ * Add the parse results of the sentence to the cache of its dictionary.
+ */
+void parse_cache_insert(Sentence sent, Parse_Options opts)
+{
+	Dictionary dict = sent->dict;
+	size_t max_size = (size_t)opts->result_cache * 1024;
+
+	if (0 == opts->result_cache) return;
+
+	/* Don't cache results that depend on random choices. */
+	if (!opts->repeatable_rand &&
+	    ((sent->num_linkages_found > (int)opts->linkage_limit) ||
+	     dict->shuffle_linkages))
+		return;
+
+	cache_entry *e = entry_new(sent);
+	if (NULL == e) return;
+
+	e->key = cache_key(sent, opts);
+	e->hash = key_hash(e->key);
+	e->size += strlen(e->key) + 1;
+	if (e->size > max_size)
+	{
+		entry_delete(e);
+		return;
+	}
+
+	spin_lock(&dict->parse_cache_lock);
+	if (NULL == dict->parse_cache) dict->parse_cache = parse_cache_new();
+	parse_cache *pc = dict->parse_cache;
+
+	if (NULL == cache_find(pc, e->key, e->hash))
+	{
+		cache_add(pc, e, max_size);
+		e = NULL;
+	}
+	spin_unlock(&dict->parse_cache_lock);
+
+	entry_delete(e); /* Already added by another thread */
+}
+
+/**
+ * Get the statistics of the parse result cache of the dictionary (see
+ * parse_options_set_result_cache()). They are all 0 if no sentence has
+ * been parsed with the cache.
+ */
+void dictionary_get_parse_cache_stats(Dictionary dict,
+                                      lg_parse_cache_stats *stats)
+{
+	memset(stats, 0, sizeof(lg_parse_cache_stats));
+	if (!dict) return;
+
+	spin_lock(&dict->parse_cache_lock);
+	parse_cache *pc = dict->parse_cache;
+	if (NULL != pc)
+	{
+		stats->lookups = pc->lookups;
+		stats->hits = pc->hits;
+		stats->evictions = pc->evictions;
+		stats->num_entries = pc->num_entries;
+		stats->bytes = pc->size;
+	}
+	spin_unlock(&dict->parse_cache_lock);
+}
+
+/**
+ * Free the parse result cache of the dictionary, after reporting its
+ * statistics.
+ */
+void parse_cache_delete(Dictionary dict)
+{
+	parse_cache *pc = dict->parse_cache;
+
+	if (NULL == pc) return;
+
+	lgdebug(D_USER_TIMES, "Info: Parse result cache: %zu lookups, "
+	        "%zu hits (%.1f%%), %zu entries (%zu bytes), %zu evictions\n",
+	        pc->lookups, pc->hits,
+	        (0 == pc->lookups) ? 0.0 : 100.0 * pc->hits / pc->lookups,
+	        pc->num_entries, pc->size, pc->evictions);
+
+	cache_entry *next;
+	for (cache_entry *e = pc->lru_head; NULL != e; e = next)
+	{
+		next = e->lru_next;
+		entry_delete(e);
+	}
+	free(pc->table);
+	free(pc);
+	dict->parse_cache = NULL;
+}
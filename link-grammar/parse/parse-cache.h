@@ -0,0 +1,21 @@
+/*************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                      */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _PARSE_CACHE_H
+#define _PARSE_CACHE_H
+#include "link-includes.h"
+
+typedef struct parse_cache_s parse_cache;
+
+bool parse_cache_lookup(Sentence, Parse_Options);
+void parse_cache_insert(Sentence, Parse_Options);
+void parse_cache_delete(Dictionary);
+#endif /* _PARSE_CACHE_H */
@@ -12,6 +12,12 @@
 /*************************************************************************/
 
 #include <limits.h>
+#if defined HAVE_PTHREAD && defined HAVE_STDATOMIC_H
+#define PARALLEL_NULL_COUNT
+#include <pthread.h>
+#include <stdatomic.h>
+#endif /* HAVE_PTHREAD && HAVE_STDATOMIC_H */
+
 #include "api-structures.h"
 #include "count.h"
 #include "dict-common/dict-common.h"   // For Dictionary_s
@@ -167,7 +173,6 @@ static void process_linkages(Sentence sent, extractor_t* pex,
 			need_init = false;
 		}
 		extract_links(pex, lkg);
-		compute_link_names(lkg, sent->string_set);
 
 		if (verbosity_level(+D_PL))
 		{
@@ -177,6 +182,9 @@ static void process_linkages(Sentence sent, extractor_t* pex,
 
 		if (sane_linkage_morphism(sent, lkg, opts))
 		{
+			/* Link names are needed only for the linkages that are kept.
+			 * remove_empty_words() needs them to identify kept links. */
+			compute_link_names(lkg);
 			remove_empty_words(lkg);
 
 			if (verbosity_level(+D_PL))
@@ -246,65 +254,263 @@ static void sort_linkages(Sentence sent, Parse_Options opts)
 	print_time(opts, "Sorted all linkages");
 }
 
-#define SHORTEST_SENTENCE_TO_PACK 9
+#define NULL_COUNT_UNKNOWN -1
 
-/**
- * Pack all disjunct and connectors into one big memory block.
- * This facilitate a better memory caching for long sentences
- * (a performance gain of a few percents).
+#ifdef PARALLEL_NULL_COUNT
+/* Concurrent counting of several null counts.
  *
- * The current Connector struct size is 32 bit, and future ones may be
- * smaller, but still with a power-of-2 size.
- * The idea is to put an integral number of connectors in each cache line
- * (assumed to be >= Connector struct size, e.g. 64 bytes),
- * so one connector will not need 2 cache lines.
+ * When a sentence has no complete linkage, the null counts are tried
+ * one after the other until one of them has valid linkages. To reduce
+ * the latency, a batch of consecutive null counts can be counted
+ * concurrently: the smallest one in the calling thread (on the sentence
+ * itself), and each of the others in its own thread, on a private copy
+ * of the sentence words and disjuncts (the counting writes into the
+ * disjuncts) with its own fast matcher and count context.
  *
- * The allocated memory includes 3 sections , in that order:
- * 1. A block for disjuncts, when it start is not aligned (the disjunct size
- * is currently 56 bytes and cannot be reduced much).
- * 2. A small alignment gap, that ends in a 64-byte boundary.
- * 3. A block of connectors, which is so aligned to 64-byte boundary.
+ * As soon as a null count is found to have linkages, the counts of the
+ * bigger null counts are cancelled. The thread results are used to skip
+ * the null counts that have no linkages. If the first null count that
+ * has linkages has been counted by a thread, its sentence disjuncts,
+ * fast matcher and count context are adopted by the sentence (see
+ * adopt_null_count_job()), so it is not counted again. Its linkages are
+ * then extracted as usual, so the results are the same as when parsing
+ * in a single thread.
  *
- * FIXME: 1. Find the "best" value for SHORTEST_SENTENCE_TO_PACK.
- * 2. Maybe this check should be done in too stages, the second one
- * will use number of disjunct and connector thresholds.
- */
-static void pack_sentence(Sentence sent)
+ * Note: The wordgraph is only read here - the hierarchy positions of
+ * its words, which are cached on demand, are computed in advance by
+ * flatten_wordgraph(). */
+
+typedef struct null_count_batch_s null_count_batch;
+
+typedef struct
+{
+	null_count_batch *batch;
+	struct Sentence_s sent;     /* Private copy of the sentence */
+	int null_count;
+	s64 total;                  /* NULL_COUNT_UNKNOWN if not counted */
+	bool started;
+	pthread_t thread;
+	fast_matcher_t *mchxt;      /* Kept if total > 0 */
+	count_context_t *ctxt;      /* Kept if total > 0 */
+} null_count_job;
+
+struct null_count_batch_s
+{
+	Parse_Options opts;
+	atomic_int found;           /* Smallest null count with linkages */
+	int num_jobs;
+	null_count_job job[];
+};
+
+static bool null_count_cancelled(void *arg)
+{
+	null_count_job *job = arg;
+
+	return atomic_load(&job->batch->found) < job->null_count;
+}
+
+static void null_count_found(null_count_batch *batch, int null_count)
 {
-	int dcnt = 0;
-	int ccnt = 0;
+	int found = atomic_load(&batch->found);
 
-	if (sent->length < SHORTEST_SENTENCE_TO_PACK) return;
-	for (size_t w = 0; w < sent->length; w++)
+	while ((null_count < found) &&
+	       !atomic_compare_exchange_weak(&batch->found, &found, null_count))
+		;
+}
+
+static void *count_null_count(void *arg)
+{
+	null_count_job *job = arg;
+	Sentence sent = &job->sent;
+	Parse_Options opts = job->batch->opts;
+
+	fast_matcher_t *mchxt = alloc_fast_matcher(sent);
+	count_context_t *ctxt = alloc_count_context(sent);
+	count_set_cancel(ctxt, null_count_cancelled, job);
+
+	Count_bin hist = do_parse(sent, mchxt, ctxt, job->null_count, opts);
+	s64 total = hist_total(&hist);
+
+	/* A cancelled or timed-out count is incomplete. */
+	if (null_count_cancelled(job) || resources_exhausted(opts->resources))
 	{
-		Disjunct *d;
+		job->total = NULL_COUNT_UNKNOWN;
+	}
+	else
+	{
+		job->total = total;
+		if (0 != total) null_count_found(job->batch, job->null_count);
+	}
 
-		for (d = sent->word[w].d; NULL != d; d = d->next)
-		{
-			dcnt++;
-			for (Connector *c = d->right; c!=NULL; c = c->next) ccnt++;
-			for (Connector *c = d->left; c != NULL; c = c->next) ccnt++;
-		}
+	if (0 < job->total)
+	{
+		/* Keep the count, in case the linkages are extracted from it. */
+		count_set_cancel(ctxt, NULL, NULL);
+		job->mchxt = mchxt;
+		job->ctxt = ctxt;
+		return NULL;
 	}
 
-#define CONN_ALIGNMENT sizeof(Connector)
-	size_t dsize = dcnt * sizeof(Disjunct);
-	dsize = ALIGN(dsize, CONN_ALIGNMENT); /* Align connector block. */
-	size_t csize = ccnt * sizeof(Connector);
-	void *memblock = malloc(dsize + csize);
-	Disjunct *dblock = memblock;
-	Connector *cblock = (Connector *)((char *)memblock + dsize);
-	sent->disjuncts_connectors_memblock = memblock;
+	free_count_context(ctxt, sent);
+	free_fast_matcher(sent, mchxt);
+	pool_delete(sent->fm_Match_node);
+	pool_delete(sent->Table_connector_pool);
+
+	return NULL;
+}
 
-	for (size_t i = 0; i < sent->length; i++)
+/**
+ * Free the sentence copy of the given job, and its count if kept.
+ */
+static void free_job_sentence(null_count_job *job)
+{
+	Sentence jsent = &job->sent;
+
+	free_count_context(job->ctxt, jsent);
+	free_fast_matcher(jsent, job->mchxt);
+	if (NULL != job->ctxt)
 	{
-		Disjunct *word_disjuncts = sent->word[i].d;
+		pool_delete(jsent->fm_Match_node);
+		pool_delete(jsent->Table_connector_pool);
+	}
+	aligned_free(jsent->disjuncts_connectors_memblock);
+	free(jsent->word);
+}
+
+/**
+ * Free a job returned by null_count_batch_finish().
+ */
+static void free_null_count_job(null_count_job *job)
+{
+	if (NULL == job) return;
+	free_job_sentence(job);
+	free(job);
+}
+
+/**
+ * Make the count of the given job the count of the sentence: Replace
+ * the sentence disjuncts, fast matcher and count context by those of
+ * the job, which were copied from the sentence when the batch started.
+ * Return the job total. The job is freed.
+ */
+static s64 adopt_null_count_job(Sentence sent, null_count_job *job,
+                                fast_matcher_t **mchxt,
+                                count_context_t **ctxt)
+{
+	Sentence jsent = &job->sent;
+	s64 total = job->total;
+
+	assert(jsent->disjuncts_connectors_memblock_sz ==
+	       sent->disjuncts_connectors_memblock_sz,
+	       "Disjuncts memory block has been changed");
+
+	free_count_context(*ctxt, sent);
+	free_fast_matcher(sent, *mchxt);
+	*ctxt = job->ctxt;
+	*mchxt = job->mchxt;
+
+	pool_delete(sent->fm_Match_node);
+	pool_delete(sent->Table_connector_pool);
+	sent->fm_Match_node = jsent->fm_Match_node;
+	sent->Table_connector_pool = jsent->Table_connector_pool;
+
+	for (WordIdx w = 0; w < sent->length; w++)
+		sent->word[w].d = jsent->word[w].d;
+	aligned_free(sent->disjuncts_connectors_memblock);
+	sent->disjuncts_connectors_memblock = jsent->disjuncts_connectors_memblock;
+
+	free(jsent->word);
+	free(job);
+
+	lgdebug(D_PARSE, "Info: Using the concurrent count with %zu null links\n",
+	        sent->null_count);
+	return total;
+}
 
-		sent->word[i].d = pack_disjuncts_dup(sent->word[i].d, &dblock, &cblock);
-		free_disjuncts(word_disjuncts);
+/**
+ * Start counting the null counts first..last, each in its own thread.
+ * The disjuncts of the sentence must be already pruned for them.
+ */
+static null_count_batch *
+null_count_batch_start(Sentence sent, Parse_Options opts, int first, int last)
+{
+	int num_jobs = last - first + 1;
+	null_count_batch *batch =
+		malloc(sizeof(null_count_batch) + num_jobs * sizeof(null_count_job));
+
+	batch->opts = opts;
+	batch->num_jobs = num_jobs;
+	atomic_init(&batch->found, INT_MAX);
+
+	for (int i = 0; i < num_jobs; i++)
+	{
+		null_count_job *job = &batch->job[i];
+		Sentence jsent = &job->sent;
+
+		job->batch = batch;
+		job->null_count = first + i;
+		job->total = NULL_COUNT_UNKNOWN;
+		job->mchxt = NULL;
+		job->ctxt = NULL;
+
+		*jsent = *sent;
+		jsent->word = malloc(sent->length * sizeof(Word));
+		memcpy(jsent->word, sent->word, sent->length * sizeof(Word));
+		jsent->disjuncts_connectors_memblock =
+			copy_sentence_disjuncts(sent, jsent->word);
+		jsent->fm_Match_node = NULL;
+		jsent->Table_connector_pool = NULL;
+		jsent->null_count = job->null_count;
+
+		job->started =
+			(0 == pthread_create(&job->thread, NULL, count_null_count, job));
 	}
+
+	lgdebug(D_PARSE, "Info: Counting null counts %d-%d concurrently\n",
+	        first, last);
+	return batch;
 }
 
+/**
+ * Wait for the batch threads and record their results in nl_total[].
+ * \p null_count and \p total are the count done in the calling thread,
+ * for the null count just before the batch ones.
+ *
+ * If that count has no linkages, return the job of the smallest batch
+ * null count that has linkages (to be adopted by the sentence, or freed
+ * by free_null_count_job()), else NULL.
+ */
+static null_count_job *
+null_count_batch_finish(null_count_batch *batch, int null_count, s64 total,
+                        s64 *nl_total)
+{
+	null_count_job *counted = NULL;
+
+	if (0 != total) null_count_found(batch, null_count);
+
+	for (int i = 0; i < batch->num_jobs; i++)
+	{
+		null_count_job *job = &batch->job[i];
+
+		if (job->started) pthread_join(job->thread, NULL);
+		nl_total[job->null_count] = job->total;
+		lgdebug(D_PARSE, "Info: Concurrent count with %d null links: %lld%s\n",
+		        job->null_count, job->total,
+		        (NULL_COUNT_UNKNOWN == job->total) ? " (not counted)" : "");
+
+		if ((0 == total) && (NULL == counted) && (0 < job->total))
+		{
+			counted = malloc(sizeof(null_count_job));
+			*counted = *job;
+			continue;
+		}
+		free_job_sentence(job);
+	}
+
+	free(batch);
+	return counted;
+}
+#endif /* PARALLEL_NULL_COUNT */
 
 /**
  * classic_parse() -- parse the given sentence.
@@ -330,26 +536,38 @@ static void pack_sentence(Sentence sent)
  * disjuncts which are not appropriate to continue do_parse() tries with
  * null_count>0. To solve that, we need to restore the original
  * disjuncts of the sentence and call pp_and_power_prune() once again.
+ * Since all the sentence disjuncts and connectors reside in one memory
+ * block (see build_sentence_disjuncts()), this is done by a snapshot of
+ * this block, which is later copied back.
+ *
+ * If opts->threads > 1, several null counts may be counted concurrently
+ * (see null_count_batch_start()), and the null counts which are thus
+ * known to have no linkages are skipped.
  */
 void classic_parse(Sentence sent, Parse_Options opts)
 {
 	fast_matcher_t * mchxt = NULL;
 	count_context_t * ctxt = NULL;
 	bool pp_and_power_prune_done = false;
-	Disjunct **disjuncts_copy = NULL;
-	bool is_null_count_0 = (0 == opts->min_null_count);
+	disjuncts_snapshot_t *disjuncts_copy = NULL;
+	int min_null_count = opts->min_null_count;
+	bool is_null_count_0 = (0 == min_null_count);
 	int max_null_count = MIN((int)sent->length, opts->max_null_count);
+	s64 *nl_total = NULL;      /* Known totals of null counts */
+#ifdef PARALLEL_NULL_COUNT
+	null_count_job *counted = NULL; /* Concurrent count with linkages */
+#endif
+	size_t disjunct_budget = opts->disjunct_budget;
+	unsigned int num_widenings = 0;
 
 	/* Build lists of disjuncts */
-	prepare_to_parse(sent, opts);
+	size_t num_trimmed = prepare_to_parse(sent, opts, disjunct_budget);
 	if (resources_exhausted(opts->resources)) return;
 
 	if (is_null_count_0 && (0 < max_null_count))
 	{
 		/* Save the disjuncts in case we need to parse with null_count>0. */
-		disjuncts_copy = alloca(sent->length * sizeof(Disjunct *));
-		for (size_t i = 0; i < sent->length; i++)
-			disjuncts_copy[i] = disjuncts_dup(sent->word[i].d);
+		disjuncts_copy = save_disjuncts(sent);
 	}
 
 	for (int nl = opts->min_null_count; nl <= max_null_count; nl++)
@@ -368,12 +586,7 @@ void classic_parse(Sentence sent, Parse_Options opts)
 				/* We are parsing now with null_count>0, when previously we
 				 * parsed with null_count==0. Restore the save disjuncts. */
 				if (NULL != disjuncts_copy)
-				{
-					free_sentence_disjuncts(sent);
-					for (size_t i = 0; i < sent->length; i++)
-						sent->word[i].d = disjuncts_copy[i];
-					disjuncts_copy = NULL;
-				}
+					restore_disjuncts(sent, disjuncts_copy);
 			}
 			pp_and_power_prune(sent, opts);
 			if (is_null_count_0) opts->min_null_count = 0;
@@ -381,7 +594,7 @@ void classic_parse(Sentence sent, Parse_Options opts)
 
 			free_count_context(ctxt, sent);
 			free_fast_matcher(sent, mchxt);
-			pack_sentence(sent);
+			if (opts->share_connector_tails) share_connector_tails(sent);
 			ctxt = alloc_count_context(sent);
 			mchxt = alloc_fast_matcher(sent);
 			print_time(opts, "Initialized fast matcher");
@@ -391,8 +604,50 @@ void classic_parse(Sentence sent, Parse_Options opts)
 		free_linkages(sent);
 
 		sent->null_count = nl;
-		hist = do_parse(sent, mchxt, ctxt, sent->null_count, opts);
-		total = hist_total(&hist);
+
+		if ((NULL != nl_total) && (0 == nl_total[nl]))
+		{
+			/* Already counted concurrently - there are no linkages. */
+			sent->num_linkages_found = 0;
+			sent->num_linkages_alloced = 0;
+			sent->num_linkages_post_processed = 0;
+			sent->num_valid_linkages = 0;
+			continue;
+		}
+
+#ifdef PARALLEL_NULL_COUNT
+		null_count_batch *batch = NULL;
+		if ((0 < nl) && (1 < opts->threads) && (nl < max_null_count) &&
+		    ((NULL == nl_total) || (NULL_COUNT_UNKNOWN == nl_total[nl])))
+		{
+			if (NULL == nl_total)
+			{
+				nl_total = malloc((max_null_count + 1) * sizeof(s64));
+				for (int i = 0; i <= max_null_count; i++)
+					nl_total[i] = NULL_COUNT_UNKNOWN;
+			}
+			batch = null_count_batch_start(sent, opts, nl + 1,
+			                  MIN(nl + opts->threads - 1, max_null_count));
+		}
+#endif /* PARALLEL_NULL_COUNT */
+
+#ifdef PARALLEL_NULL_COUNT
+		if ((NULL != counted) && (counted->null_count == nl))
+		{
+			total = adopt_null_count_job(sent, counted, &mchxt, &ctxt);
+			counted = NULL;
+		}
+		else
+#endif /* PARALLEL_NULL_COUNT */
+		{
+			hist = do_parse(sent, mchxt, ctxt, sent->null_count, opts);
+			total = hist_total(&hist);
+		}
+
+#ifdef PARALLEL_NULL_COUNT
+		if (NULL != batch)
+			counted = null_count_batch_finish(batch, nl, total, nl_total);
+#endif /* PARALLEL_NULL_COUNT */
 
 		lgdebug(D_PARSE, "Info: Total count with %zu null links:   %lld\n",
 		        sent->null_count, total);
@@ -412,6 +667,40 @@ void classic_parse(Sentence sent, Parse_Options opts)
 		post_process_lkgs(sent, opts);
 
 		if (sent->num_valid_linkages > 0) break;
+
+		if ((min_null_count == nl) && (0 < num_trimmed) &&
+		    (PARSE_NUM_OVERFLOW >= total))
+		{
+			/* The disjuncts which are needed for a linkage with this
+			 * null_count may have been dropped due to the disjunct
+			 * budget. Widen it and parse again with the same null_count.
+			 * A sentence that needs null links has no complete linkage
+			 * anyway, so then don't bother with gradual widening. */
+			disjunct_budget = (0 == nl) ? 2 * disjunct_budget : 0;
+			num_widenings++;
+			lgdebug(D_USER_TIMES, "Info: %zu words over the disjunct budget; "
+			        "widening it to %zu\n", num_trimmed, disjunct_budget);
+
+			free_disjuncts_snapshot(disjuncts_copy);
+			disjuncts_copy = NULL;
+
+			/* The concurrent counts were done with the old budget. */
+			free(nl_total);
+			nl_total = NULL;
+#ifdef PARALLEL_NULL_COUNT
+			free_null_count_job(counted);
+			counted = NULL;
+#endif /* PARALLEL_NULL_COUNT */
+
+			num_trimmed = prepare_to_parse(sent, opts, disjunct_budget);
+			if (resources_exhausted(opts->resources)) break;
+			if (is_null_count_0 && (0 < max_null_count))
+				disjuncts_copy = save_disjuncts(sent);
+			pp_and_power_prune_done = false;
+			nl--;
+			continue;
+		}
+
 		if ((0 == nl) && (0 < max_null_count) && verbosity > 0)
 			prt_error("No complete linkages found.\n");
 
@@ -422,11 +711,17 @@ void classic_parse(Sentence sent, Parse_Options opts)
 	}
 	sort_linkages(sent, opts);
 
-	if (NULL != disjuncts_copy)
+	if (0 < num_widenings)
 	{
-		for (size_t i = 0; i < sent->length; i++)
-			free_disjuncts(disjuncts_copy[i]);
+		lgdebug(D_USER_TIMES, "Info: Widened the disjunct budget %u times\n",
+		        num_widenings);
 	}
+
+	free(nl_total);
+#ifdef PARALLEL_NULL_COUNT
+	free_null_count_job(counted);
+#endif /* PARALLEL_NULL_COUNT */
+	free_disjuncts_snapshot(disjuncts_copy);
 	free_count_context(ctxt, sent);
 	free_fast_matcher(sent, mchxt);
 }
@@ -42,6 +42,8 @@ static int set_dist_fields(Connector * c, size_t w, int delta)
  * Initialize the word fields of the connectors, and
  * eliminate those disjuncts that are so long, that they
  * would need to connect past the end of the sentence.
+ * (The eliminated disjuncts are in the sentence memory block, so they
+ * are not freed here.)
  */
 static void setup_connectors(Sentence sent)
 {
@@ -56,14 +58,10 @@ static void setup_connectors(Sentence sent)
 			if ((set_dist_fields(d->left, w, -1) < 0) ||
 			    (set_dist_fields(d->right, w, 1) >= (int) sent->length))
 			{
-				d->next = NULL;
-				free_disjuncts(d);
-			}
-			else
-			{
-				d->next = head;
-				head = d;
+				continue;
 			}
+			d->next = head;
+			head = d;
 		}
 		sent->word[w].d = head;
 	}
@@ -88,36 +86,37 @@ static void gword_record_in_connector(Sentence sent)
 }
 
 /**
- * Turn sentence expressions into disjuncts.
- * Sentence expressions must have been built, before calling this routine.
+ * Eliminate the duplicate disjuncts of word w.
+ * This is done per word, and the words may be done concurrently (the
+ * gword sets of the disjuncts of different words are distinct).
+ * After the resources got exhausted the rest of the words are skipped.
  */
-static void build_sentence_disjuncts(Sentence sent, double cost_cutoff,
-                                     Parse_Options opts)
+typedef struct
 {
-	Disjunct * d;
-	X_node * x;
-	size_t w;
-	for (w = 0; w < sent->length; w++)
-	{
-		d = NULL;
-		for (x = sent->word[w].x; x != NULL; x = x->next)
-		{
-			Disjunct *dx = build_disjuncts_for_exp(x->exp, x->string, cost_cutoff, opts);
-			word_record_in_disjunct(x->word, dx);
-			d = catenate_disjuncts(dx, d);
-		}
-		sent->word[w].d = d;
-	}
+	Sentence sent;
+	Parse_Options opts;
+} word_job_t;
+
+static void eliminate_word_duplicates(size_t w, void *arg)
+{
+	word_job_t *job = arg;
+
+	if (resources_exhausted(job->opts->resources)) return;
+	job->sent->word[w].d = eliminate_duplicate_disjuncts(job->sent->word[w].d);
 }
 
 /**
  * Assumes that the sentence expression lists have been generated.
+ * Return the number of words whose disjuncts have been trimmed to the
+ * disjunct budget (see build_sentence_disjuncts()).
  */
-void prepare_to_parse(Sentence sent, Parse_Options opts)
+size_t prepare_to_parse(Sentence sent, Parse_Options opts,
+                        size_t disjunct_budget)
 {
-	size_t i;
+	size_t num_trimmed;
 
-	build_sentence_disjuncts(sent, opts->disjunct_cost, opts);
+	num_trimmed = build_sentence_disjuncts(sent, opts->disjunct_cost,
+	                                       disjunct_budget, opts);
 	if (verbosity_level(5))
 	{
 		prt_error("Debug: After expanding expressions into disjuncts:\n");
@@ -125,14 +124,12 @@ void prepare_to_parse(Sentence sent, Parse_Options opts)
 	}
 	print_time(opts, "Built disjuncts");
 
-	for (i=0; i<sent->length; i++)
-	{
-		sent->word[i].d = eliminate_duplicate_disjuncts(sent->word[i].d);
+	word_job_t job = { .sent = sent, .opts = opts };
+	parallel_for(sent->length, opts->threads, eliminate_word_duplicates, &job);
 
-		/* Some long Russian sentences can really blow up, here. */
-		if (resources_exhausted(opts->resources))
-			return;
-	}
+	/* Some long Russian sentences can really blow up, here. */
+	if (resources_exhausted(opts->resources))
+		return num_trimmed;
 	print_time(opts, "Eliminated duplicate disjuncts");
 
 	if (verbosity_level(5))
@@ -143,4 +140,6 @@ void prepare_to_parse(Sentence sent, Parse_Options opts)
 
 	gword_record_in_connector(sent);
 	setup_connectors(sent);
+
+	return num_trimmed;
 }
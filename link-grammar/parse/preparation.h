@@ -15,5 +15,5 @@
 #define _PREPARATION_H
 #include "link-includes.h"
 
-void prepare_to_parse(Sentence, Parse_Options);
+size_t prepare_to_parse(Sentence, Parse_Options, size_t disjunct_budget);
 #endif /* _PREPARATION_H */
@@ -59,21 +59,6 @@ struct power_table_s
 	Pool_desc *memory_pool;
 };
 
-typedef struct cms_struct Cms;
-struct cms_struct
-{
-	Cms * next;
-	const char * name;
-	int count; /* the number of times this is in the multiset */
-};
-
-#define CMS_SIZE (2<<10)
-typedef struct multiset_table_s multiset_table;
-struct multiset_table_s
-{
-	Cms * cms_table[CMS_SIZE];
-};
-
 typedef struct prune_context_s prune_context;
 struct prune_context_s
 {
@@ -595,7 +580,7 @@ int power_prune(Sentence sent, Parse_Options opts)
 {
 	power_table *pt;
 	prune_context *pc;
-	Disjunct *d, *free_later, *dx, *nd;
+	Disjunct *d, *dx, *nd;
 	Connector *c;
 	size_t N_deleted, total_deleted;
 	size_t w;
@@ -610,7 +595,6 @@ int power_prune(Sentence sent, Parse_Options opts)
 	pt = power_table_new(sent);
 	pc->pt = pt;
 
-	free_later = NULL;
 	N_deleted = 0;
 
 	total_deleted = 0;
@@ -636,10 +620,7 @@ int power_prune(Sentence sent, Parse_Options opts)
 			nd = NULL;
 			for (d = sent->word[w].d; d != NULL; d = dx) {
 				dx = d->next;
-				if ((d->left != NULL) && (d->left->nearest_word == BAD_WORD)) {
-					d->next = free_later;
-					free_later = d;
-				} else {
+				if ((d->left == NULL) || (d->left->nearest_word != BAD_WORD)) {
 					d->next = nd;
 					nd = d;
 				}
@@ -671,10 +652,7 @@ int power_prune(Sentence sent, Parse_Options opts)
 			nd = NULL;
 			for (d = sent->word[w].d; d != NULL; d = dx) {
 				dx = d->next;
-				if ((d->right != NULL) && (d->right->nearest_word == BAD_WORD)) {
-					d->next = free_later;
-					free_later = d;
-				} else {
+				if ((d->right == NULL) || (d->right->nearest_word != BAD_WORD)) {
 					d->next = nd;
 					nd = d;
 				}
@@ -688,7 +666,6 @@ int power_prune(Sentence sent, Parse_Options opts)
 		if (pc->N_changed == 0) break;
 		pc->N_changed = N_deleted = 0;
 	}
-	free_disjuncts(free_later);
 	power_table_delete(pt);
 	pt = NULL;
 	pc->pt = NULL;
@@ -751,157 +728,116 @@ int power_prune(Sentence sent, Parse_Options opts)
    the rule.  If none can match, then we can delete the disjunct
    containing C.
 
-   Here's how we're going to implement this.  We'll maintain a multiset
-   of connector names.  We'll represent them in a hash table, where the
-   hash function uses only the upper case letters of the connector name.
-   We'll insert all the connectors into the multiset.  The multiset will
-   support the operation of deletion (probably simplest to just
-   decrement the count).  Here's the algorithm.
+   Here's how we're going to implement this.  When the dictionary is
+   read, pp_prune_table_setup() breaks each criterion link into the
+   connector names ("probes") that must all be matched, like "Xa##",
+   "X#b#" and "X##c" above, and numbers them.  Then it finds, for each
+   connector descriptor, the rules it triggers and the probes it
+   matches.  Only the descriptors that have any of them are kept, in a
+   table that is hashed by the descriptor address.
 
-   Insert all the connectors into M.
+   For a sentence, we maintain the multiplicity of each probe, i.e. the
+   number of connectors that match it, in an array indexed by the probe
+   number.  Here's the algorithm.
 
-   While the previous pass caused a count to go to 0 do:
+   Count the probes of all the connectors.
+
+   While the previous pass caused a probe count to go to 0 do:
 	  For each connector C do
-		 For each rule R do
-			if C is a trigger for R and the criterion links
-			of the rule cannot be satisfied by the connectors in
-			M, Then:
+		 For each rule R that C triggers do
+			if the criterion links of the rule cannot be satisfied
+			(for each of them, some probe has a 0 count), Then:
 			   We delete C's disjunct.  But before we do,
-			   we remove all the connectors of this disjunct
-			   from the multiset.  Keep tabs on whether or not
-			   any of the counts went to 0.
-
-
-
-	Efficiency hacks to be added later:
-		Note for a given rule can become less and less satisfiable.
-		That is, rule_satisfiable(r) for a given rule r can change from
-		TRUE to FALSE, but not vice versa.  So once it's FALSE, we can just
-		remember that.
-
-		Consider the effect of a pass p on the set of rules that are
-		satisfiable.  Suppose this set does not change.  Then pass p+1
-		will do nothing.  This is true even if pass p caused some
-		disjuncts to be deleted.  (This observation will only obviate
-		the need for the last pass.)
-
+			   we decrement the counts of the probes of all the
+			   connectors of this disjunct.  Keep tabs on whether
+			   or not any of the counts went to 0.
   */
 
-static multiset_table * cms_table_new(void)
+typedef struct
 {
-	multiset_table *mt;
-	int i;
-
-	mt = (multiset_table *) xalloc(sizeof(multiset_table));
-
-	for (i=0; i<CMS_SIZE; i++) {
-		mt->cms_table[i] = NULL;
-	}
-	return mt;
-}
-
-static void cms_table_delete(multiset_table *mt)
+	const condesc_t *desc;
+	unsigned int *rule;       /* Indices of the rules it triggers */
+	unsigned int *probe;      /* Indices of the probes it matches */
+	unsigned int num_rules;
+	unsigned int num_probes;
+} pp_desc;
+
+struct pp_prune_table_s
 {
-	Cms * cms, *xcms;
-	int i;
-	for (i=0; i<CMS_SIZE; i++)
-	{
-		for (cms = mt->cms_table[i]; cms != NULL; cms = xcms)
-		{
-			xcms = cms->next;
-			xfree(cms, sizeof(Cms));
-		}
-	}
-	xfree(mt, sizeof(multiset_table));
-}
+	pp_desc *desc;            /* Hashed by the descriptor address */
+	size_t size;              /* A power of 2 */
+	unsigned int num_probes;
+	/* Per contains-one rule (NULL for rules with a wildcard selector):
+	 * The number of criterion links, and for each of them the number
+	 * of its probes followed by their indices. */
+	unsigned int **criterion;
+	size_t num_criterion;
+};
 
-static unsigned int cms_hash(const char * s)
+static size_t pp_desc_hash(const condesc_t *desc, size_t size)
 {
-	unsigned int i = 5381;
-	if (islower((int) *s)) s++; /* skip head-dependent indicator */
-	while (isupper((int) *s))
-	{
-		i = ((i << 5) + i) + *s;
-		s++;
-	}
-	return (i & (CMS_SIZE-1));
+	/* The descriptors are allocated from a pool. */
+	return ((uintptr_t)desc / sizeof(condesc_t)) & (size - 1);
 }
 
-/**
- * This returns TRUE if there is a connector name C in the table
- * such that post_process_match(pp_match_name, C) is TRUE
- */
-static bool match_in_cms_table(multiset_table *cmt, const char * pp_match_name)
+static const pp_desc *pp_desc_lookup(const pp_prune_table *pt,
+                                     const condesc_t *desc)
 {
-	Cms * cms;
-	for (cms = cmt->cms_table[cms_hash(pp_match_name)]; cms != NULL; cms = cms->next)
-	{
-		if (post_process_match(pp_match_name, cms->name)) return true;
-	}
-	return false;
-}
+	size_t h = pp_desc_hash(desc, pt->size);
 
-static Cms * lookup_in_cms_table(multiset_table *cmt, const char * str)
-{
-	Cms * cms;
-	for (cms = cmt->cms_table[cms_hash(str)]; cms != NULL; cms = cms->next)
+	for (; NULL != pt->desc[h].desc; h = (h + 1) & (pt->size - 1))
 	{
-		if (string_set_cmp(str, cms->name)) return cms;
+		if (desc == pt->desc[h].desc) return &pt->desc[h];
 	}
 	return NULL;
 }
 
-static void insert_in_cms_table(multiset_table *cmt, const char * str)
-{
-	Cms * cms;
-	unsigned int h;
-	cms = lookup_in_cms_table(cmt, str);
-	if (cms != NULL) {
-		cms->count++;
-	} else {
-		cms = (Cms *) xalloc(sizeof(Cms));
-		cms->name = str;  /* don't copy the string...just keep a pointer to it.
-							 we won't free these later */
-		cms->count = 1;
-		h = cms_hash(str);
-		cms->next = cmt->cms_table[h];
-		cmt->cms_table[h] = cms;
-	}
-}
-
 /**
- * Delete the given string from the table.  Return TRUE if
- * this caused a count to go to 0, return FALSE otherwise.
+ * Return the index of the given probe, adding it if it is new.
  */
-static bool delete_from_cms_table(multiset_table *cmt, const char * str)
+static unsigned int probe_index(const char ***probes, unsigned int *num_probes,
+                                size_t *probes_size, const char *probe,
+                                String_set *ss)
 {
-	Cms * cms = lookup_in_cms_table(cmt, str);
-	if (cms != NULL && cms->count > 0)
+	probe = string_set_add(probe, ss);
+	for (unsigned int i = 0; i < *num_probes; i++)
+		if (probe == (*probes)[i]) return i;
+
+	if (*num_probes == *probes_size)
 	{
-		cms->count--;
-		return (cms->count == 0);
+		*probes_size = (0 == *probes_size) ? 64 : 2 * *probes_size;
+		*probes = realloc(*probes, *probes_size * sizeof(**probes));
 	}
-	return false;
+	(*probes)[*num_probes] = probe;
+	return (*num_probes)++;
 }
 
-static bool rule_satisfiable(multiset_table *cmt, pp_linkset *ls)
+/**
+ * Break the criterion links of the rule into probes, as explained
+ * above, and return their encoding (see pp_prune_table_s).
+ */
+static unsigned int *rule_criterion(pp_linkset *ls, const char ***probes,
+                                    unsigned int *num_probes,
+                                    size_t *probes_size, String_set *ss)
 {
 	unsigned int hashval;
 	const char * t;
 	char name[20], *s;
 	pp_linkset_node *p;
-	int bad, n_subscripts;
+	size_t n = 1;
+	unsigned int *crit = malloc((1 + ls->population * (1 + sizeof(name))) *
+	                            sizeof(*crit));
 
+	crit[0] = 0;
 	for (hashval = 0; hashval < ls->hash_table_size; hashval++)
 	{
 		for (p = ls->hash_table[hashval]; p!=NULL; p=p->next)
 		{
-			/* ok, we've got our hands on one of the criterion links */
+			size_t len_pos = n++;
+			unsigned int n_subscripts = 0;
+
 			strncpy(name, p->str, sizeof(name)-1);
-			/* could actually use the string in place because we change it back */
 			name[sizeof(name)-1] = '\0';
-			/* now we want to see if we can satisfy this criterion link */
-			/* with a collection of the links in the cms table */
 
 			s = name;
 			if (islower((int)*s)) s++; /* skip head-dependent indicator */
@@ -915,32 +851,188 @@ static bool rule_satisfiable(multiset_table *cmt, pp_linkset *ls)
 			for (; isupper((int) *s); s++, t++) {}
 
 			/* s and t remain in lockstep */
-			bad = 0;
-			n_subscripts = 0;
-			for (;*s != '\0' && bad==0; s++, t++) {
+			for (;*s != '\0'; s++, t++) {
 				if (*s == '*') continue;
 				n_subscripts++;
 				/* after the upper case part, and is not a * so must be a regular subscript */
 				*s = *t;
-				if (!match_in_cms_table(cmt, name)) bad++;
+				crit[n++] = probe_index(probes, num_probes, probes_size, name, ss);
 				*s = '#';
 			}
 
 			if (n_subscripts == 0) {
 				/* now we handle the special case which occurs if there
 				   were 0 subscripts */
-				if (!match_in_cms_table(cmt, name)) bad++;
+				crit[n++] = probe_index(probes, num_probes, probes_size, name, ss);
+				n_subscripts = 1;
 			}
 
-			/* now if bad==0 this criterion link does the job
-			   to satisfy the needs of the trigger link */
+			crit[len_pos] = n_subscripts;
+			crit[0]++;
+		}
+	}
+
+	return crit;
+}
+
+/**
+ * Build the pp_prune() tables of the dictionary. Must be called after
+ * its connector descriptor table is complete.
+ */
+void pp_prune_table_setup(Dictionary dict)
+{
+	pp_knowledge *knowledge = dict->base_knowledge;
+	ConTable *ct = &dict->contable;
+
+	if (NULL == knowledge) return;
+
+	pp_prune_table *pt = malloc(sizeof(pp_prune_table));
+	String_set *ss = string_set_create();
+	const char **probes = NULL;
+	size_t probes_size = 0;
+
+	pt->num_probes = 0;
+	pt->num_criterion = knowledge->n_contains_one_rules;
+	pt->criterion = malloc(pt->num_criterion * sizeof(*pt->criterion));
+	for (size_t r = 0; r < knowledge->n_contains_one_rules; r++)
+	{
+		pp_rule *rule = &knowledge->contains_one_rules[r];
+
+		/* If the selector has a *, forget it (see above). */
+		if (rule->selector_has_wildcard)
+		{
+			pt->criterion[r] = NULL;
+			continue;
+		}
+		pt->criterion[r] = rule_criterion(rule->link_set, &probes,
+		                                  &pt->num_probes, &probes_size, ss);
+	}
+
+	pt->size = 16;
+	while (pt->size < 2 * ct->num_con) pt->size *= 2;
+	pt->desc = malloc(pt->size * sizeof(pp_desc));
+	memset(pt->desc, 0, pt->size * sizeof(pp_desc));
+
+	unsigned int *rule = malloc((pt->num_criterion + 1) * sizeof(*rule));
+	unsigned int *probe = malloc((pt->num_probes + 1) * sizeof(*probe));
+	size_t num_kept = 0;
+
+	for (size_t n = 0; n < ct->size; n++)
+	{
+		const condesc_t *desc = ct->hdesc[n].desc;
+		unsigned int num_rules = 0;
+		unsigned int num_probes = 0;
+
+		if (NULL == desc) continue;
 
-			if (bad == 0) return true;
+		for (size_t r = 0; r < pt->num_criterion; r++)
+		{
+			if (NULL == pt->criterion[r]) continue;
+			if (post_process_match(knowledge->contains_one_rules[r].selector,
+			                       desc->string))
+				rule[num_rules++] = r;
 		}
+		for (unsigned int i = 0; i < pt->num_probes; i++)
+		{
+			if (post_process_match(probes[i], desc->string))
+				probe[num_probes++] = i;
+		}
+		if ((0 == num_rules) && (0 == num_probes)) continue;
+
+		size_t h = pp_desc_hash(desc, pt->size);
+		while (NULL != pt->desc[h].desc) h = (h + 1) & (pt->size - 1);
+
+		pp_desc *pd = &pt->desc[h];
+		pd->desc = desc;
+		pd->num_rules = num_rules;
+		pd->num_probes = num_probes;
+		pd->rule = malloc(num_rules * sizeof(*rule));
+		memcpy(pd->rule, rule, num_rules * sizeof(*rule));
+		pd->probe = malloc(num_probes * sizeof(*probe));
+		memcpy(pd->probe, probe, num_probes * sizeof(*probe));
+		num_kept++;
+	}
+
+	lgdebug(+D_PRUNE, "Dictionary %s: %zu of %zu connector types "
+	        "are relevant for pp pruning (%u probes)\n",
+	        dict->name, num_kept, ct->num_con, pt->num_probes);
+
+	free(rule);
+	free(probe);
+	free(probes);
+	string_set_delete(ss);
+	dict->pp_prune_table = pt;
+}
+
+void pp_prune_table_delete(Dictionary dict)
+{
+	pp_prune_table *pt = dict->pp_prune_table;
+
+	if (NULL == pt) return;
+
+	for (size_t h = 0; h < pt->size; h++)
+	{
+		free(pt->desc[h].rule);
+		free(pt->desc[h].probe);
+	}
+	for (size_t r = 0; r < pt->num_criterion; r++)
+		free(pt->criterion[r]);
+	free(pt->criterion);
+	free(pt->desc);
+	free(pt);
+	dict->pp_prune_table = NULL;
+}
+
+static bool rule_satisfiable(const unsigned int *crit,
+                             const unsigned int *probe_count)
+{
+	const unsigned int *p = &crit[1];
+
+	for (unsigned int l = 0; l < crit[0]; l++)
+	{
+		unsigned int len = *p++;
+		unsigned int i;
+
+		/* Can this criterion link be made of the sentence connectors? */
+		for (i = 0; i < len; i++)
+			if (0 == probe_count[p[i]]) break;
+		if (i == len) return true;
+
+		p += len;
 	}
 	return false;
 }
 
+/**
+ * Add the connectors of the disjunct to the probe counts, or remove
+ * them if \p remove is true. Return true if a count went to 0.
+ */
+static bool update_probe_counts(const pp_prune_table *pt,
+                                unsigned int *probe_count,
+                                Disjunct *d, bool remove)
+{
+	bool zero_count = false;
+
+	for (int dir = 0; dir < 2; dir++)
+	{
+		for (Connector *c = (dir) ? d->left : d->right; NULL != c; c = c->next)
+		{
+			const pp_desc *pd = pp_desc_lookup(pt, connector_desc(c));
+			if (NULL == pd) continue;
+
+			for (unsigned int i = 0; i < pd->num_probes; i++)
+			{
+				if (!remove)
+					probe_count[pd->probe[i]]++;
+				else if (0 == --probe_count[pd->probe[i]])
+					zero_count = true;
+			}
+		}
+	}
+
+	return zero_count;
+}
+
 static void delete_unmarked_disjuncts(Sentence sent)
 {
 	size_t w;
@@ -953,9 +1045,6 @@ static void delete_unmarked_disjuncts(Sentence sent)
 			if (d->marked) {
 				d->next = d_head;
 				d_head = d;
-			} else {
-				d->next = NULL;
-				free_disjuncts(d);
 			}
 		}
 		sent->word[w].d = d_head;
@@ -965,33 +1054,27 @@ static void delete_unmarked_disjuncts(Sentence sent)
 static int pp_prune(Sentence sent, Parse_Options opts)
 {
 	pp_knowledge * knowledge;
-	size_t i, w;
+	const pp_prune_table *pt = sent->dict->pp_prune_table;
+	size_t w;
 	int total_deleted, N_deleted;
-	bool change, deleteme;
-	multiset_table *cmt;
+	bool change;
+	unsigned int *probe_count;
 
 	if (sent->postprocessor == NULL) return 0;
 	if (!opts->perform_pp_prune) return 0;
+	if (NULL == pt) return 0;
 
 	knowledge = sent->postprocessor->knowledge;
 
-	cmt = cms_table_new();
+	probe_count = malloc((pt->num_probes + 1) * sizeof(*probe_count));
+	memset(probe_count, 0, pt->num_probes * sizeof(*probe_count));
 
 	for (w = 0; w < sent->length; w++)
 	{
-		Disjunct *d;
-		for (d = sent->word[w].d; d != NULL; d = d->next)
+		for (Disjunct *d = sent->word[w].d; d != NULL; d = d->next)
 		{
-			char dir;
 			d->marked = true;
-			for (dir=0; dir < 2; dir++)
-			{
-				Connector *c;
-				for (c = ((dir) ? (d->left) : (d->right)); c != NULL; c = c->next)
-				{
-					insert_in_cms_table(cmt, connector_string(c));
-				}
-			}
+			update_probe_counts(pt, probe_count, d, false);
 		}
 	}
 
@@ -999,50 +1082,37 @@ static int pp_prune(Sentence sent, Parse_Options opts)
 	change = true;
 	while (change)
 	{
-		char dir;
-
 		change = false;
 		N_deleted = 0;
 		for (w = 0; w < sent->length; w++)
 		{
-			Disjunct *d;
-			for (d = sent->word[w].d; d != NULL; d = d->next)
+			for (Disjunct *d = sent->word[w].d; d != NULL; d = d->next)
 			{
+				bool deleteme = false;
+
 				if (!d->marked) continue;
-				deleteme = false;
-				for (i = 0; i < knowledge->n_contains_one_rules; i++)
+				for (int dir = 0; (dir < 2) && !deleteme; dir++)
 				{
-					pp_rule* rule = &knowledge->contains_one_rules[i]; /* the ith rule */
-					const char * selector = rule->selector;  /* selector string for this rule */
-					pp_linkset * link_set = rule->link_set;  /* the set of criterion links */
-
-					if (rule->selector_has_wildcard) continue;  /* If it has a * forget it */
-
-					for (dir = 0; dir < 2; dir++)
+					Connector *c = (dir) ? d->left : d->right;
+					for (; (NULL != c) && !deleteme; c = c->next)
 					{
-						Connector *c;
-						for (c = ((dir) ? (d->left) : (d->right)); c != NULL; c = c->next)
-						{
+						const pp_desc *pd = pp_desc_lookup(pt, connector_desc(c));
+						if (NULL == pd) continue;
 
-							if (!post_process_match(selector, connector_string(c))) continue;
-
-							/*
-							printf("pp_prune: trigger ok.  selector = %s  c->string = %s\n", selector, c->string);
-							*/
-
-							/* We know c matches the trigger link of the rule. */
-							/* Now check the criterion links */
+						/* c matches the trigger link of these rules.
+						 * Now check their criterion links. */
+						for (unsigned int i = 0; i < pd->num_rules; i++)
+						{
+							unsigned int r = pd->rule[i];
 
-							if (!rule_satisfiable(cmt, link_set))
+							if (!rule_satisfiable(pt->criterion[r], probe_count))
 							{
 								deleteme = true;
-								rule->use_count++;
+								knowledge->contains_one_rules[r].use_count++;
+								break;
 							}
-							if (deleteme) break;
 						}
-						if (deleteme) break;
 					}
-					if (deleteme) break;
 				}
 
 				if (deleteme)         /* now we delete this disjunct */
@@ -1050,14 +1120,7 @@ static int pp_prune(Sentence sent, Parse_Options opts)
 					N_deleted++;
 					total_deleted++;
 					d->marked = false; /* mark for deletion later */
-					for (dir=0; dir < 2; dir++)
-					{
-						Connector *c;
-						for (c = ((dir) ? (d->left) : (d->right)); c != NULL; c = c->next)
-						{
-							change |= delete_from_cms_table(cmt, connector_string(c));
-						}
-					}
+					change |= update_probe_counts(pt, probe_count, d, true);
 				}
 			}
 		}
@@ -1065,7 +1128,7 @@ static int pp_prune(Sentence sent, Parse_Options opts)
 		lgdebug(D_PRUNE, "Debug: pp_prune pass deleted %d\n", N_deleted);
 	}
 	delete_unmarked_disjuncts(sent);
-	cms_table_delete(cmt);
+	free(probe_count);
 
 	if ((0 != N_deleted) && verbosity_level(D_PRUNE))
 	{
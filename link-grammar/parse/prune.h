@@ -15,7 +15,11 @@
 
 #include "link-includes.h"
 
+typedef struct pp_prune_table_s pp_prune_table;
+
 int        power_prune(Sentence, Parse_Options);
 void       pp_and_power_prune(Sentence, Parse_Options);
+void       pp_prune_table_setup(Dictionary);
+void       pp_prune_table_delete(Dictionary);
 
 #endif /* _PRUNE_H */
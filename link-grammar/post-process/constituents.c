@@ -30,7 +30,6 @@
 #define OPEN_BRACKET '['
 #define CLOSE_BRACKET ']'
 
-typedef enum {OPEN_TOK, CLOSE_TOK, WORD_TOK} CType;
 typedef enum {NONE, STYPE, PTYPE, QTYPE, QDTYPE} WType;
 
 typedef struct
@@ -957,9 +956,51 @@ static int read_constituents_from_domains(con_context_t *ctxt, Linkage linkage,
 	return numcon_subl;
 }
 
-static char *
-exprint_constituent_structure(con_context_t *ctxt,
-                              Linkage linkage, int numcon_total)
+/**
+ * Copy the given linkage word into s (of size MAX_WORD).
+ *
+ * Constituent processing will crash if the sentence contains
+ * square brackets, so we have to do something ... replace
+ * them with curly braces ... this is a terrible hack, but
+ * will have to do; for now.  A better solution would be to
+ * allow the user to specify some reserved char as the
+ * bracket symbol, e.g. SOH and EOT or something like that.
+ */
+static void constituent_word(char *s, const char *word)
+{
+	char *p;
+	safe_strcpy(s, word, MAX_WORD);
+
+	p = strchr(s, OPEN_BRACKET);
+	while (p)
+	{
+		*p = '{';
+		p = strchr(p, OPEN_BRACKET);
+	}
+
+	p = strchr(s, CLOSE_BRACKET);
+	while (p)
+	{
+		*p = '}';
+		p = strchr(p, CLOSE_BRACKET);
+	}
+}
+
+/* Callbacks of walk_constituents(). */
+typedef struct
+{
+	void (*open)(void *data, const char *type);
+	void (*word)(void *data, const char *word);
+	bool (*close)(void *data, const char *type); /* true: stop the walk */
+} constituent_walker;
+
+/**
+ * Walk the constituents in their bracketed order, calling the walker
+ * callbacks for each opening constituent, word and closing constituent.
+ */
+static void walk_constituents(con_context_t *ctxt, Linkage linkage,
+                              int numcon_total,
+                              const constituent_walker *walker, void *data)
 {
 	size_t w;
 	int c;
@@ -967,7 +1008,6 @@ exprint_constituent_structure(con_context_t *ctxt,
 	bool *rightdone = alloca(numcon_total * sizeof(bool));
 	int best, bestright, bestleft;
 	char s[MAX_WORD];
-	dyn_str * cs = dyn_str_new();
 
 	assert (numcon_total < ctxt->conlen, "Too many constituents (b)");
 
@@ -999,38 +1039,13 @@ exprint_constituent_structure(con_context_t *ctxt,
 				break;
 
 			leftdone[best] = true;
-			dyn_strcat(cs, "[");
-			dyn_strcat(cs, ctxt->constituent[best].type);
-			dyn_strcat(cs, " ");
+			walker->open(data, ctxt->constituent[best].type);
 		}
 
 		/* Don't print out right wall */
 		if (w < linkage->num_words - 1)
 		{
-			char *p;
-			strncpy(s, linkage->word[w], MAX_WORD);
-			s[MAX_WORD-1] = 0;
-
-			/* Constituent processing will crash if the sentence contains
-			 * square brackets, so we have to do something ... replace
-			 * them with curly braces ... this is a terrible hack, but
-			 * will have to do; for now.  A better solution would be to
-			 * allow the user to specify some reserved char as the
-			 * bracket symbol, e.g. SOH and EOT or something like that.
-			 */
-			p = strchr(s, OPEN_BRACKET);
-			while (p)
-			{
-				*p = '{';
-				p = strchr(p, OPEN_BRACKET);
-			}
-
-			p = strchr(s, CLOSE_BRACKET);
-			while (p)
-			{
-				*p = '}';
-				p = strchr(p, CLOSE_BRACKET);
-			}
+			constituent_word(s, linkage->word[w]);
 
 #if 0 /* firstupper check removed in 0c8107a */
 			/* Now, if the first character of the word was
@@ -1038,8 +1053,7 @@ exprint_constituent_structure(con_context_t *ctxt,
 			if (linkage->chosen_disjuncts[w]->word[0]->status & WS_FIRSTUPPER)
 				upcase_utf8_str(s, s, MAX_WORD);
 #endif
-			dyn_strcat(cs, s);
-			dyn_strcat(cs, " ");
+			walker->word(data, s);
 		}
 
 		while (1)
@@ -1058,19 +1072,59 @@ exprint_constituent_structure(con_context_t *ctxt,
 			if (best == -1)
 				break;
 			rightdone[best] = true;
-			dyn_strcat(cs, ctxt->constituent[best].type);
-			dyn_strcat(cs, "] ");
+			if (walker->close(data, ctxt->constituent[best].type)) return;
 		}
 	}
+}
+
+static void flat_open(void *data, const char *type)
+{
+	dyn_str *cs = data;
+
+	dyn_strcat(cs, "[");
+	dyn_strcat(cs, type);
+	dyn_strcat(cs, " ");
+}
+
+static void flat_word(void *data, const char *word)
+{
+	dyn_str *cs = data;
+
+	dyn_strcat(cs, word);
+	dyn_strcat(cs, " ");
+}
+
+static bool flat_close(void *data, const char *type)
+{
+	dyn_str *cs = data;
+
+	dyn_strcat(cs, type);
+	dyn_strcat(cs, "] ");
+	return false;
+}
+
+static char *
+exprint_constituent_structure(con_context_t *ctxt,
+                              Linkage linkage, int numcon_total)
+{
+	static const constituent_walker flat_walker =
+		{ flat_open, flat_word, flat_close };
+	dyn_str * cs = dyn_str_new();
+
+	walk_constituents(ctxt, linkage, numcon_total, &flat_walker, cs);
 
 	dyn_strcat(cs, "\n");
 	return dyn_str_take(cs);
 }
 
-static char * do_print_flat_constituents(con_context_t *ctxt, Linkage linkage)
+/**
+ * Generate the constituents of the linkage into ctxt.
+ * Return the number of constituents. When done with them,
+ * constituents_done() must be called.
+ */
+static int generate_constituents(con_context_t *ctxt, Linkage linkage)
 {
 	int numcon_total= 0, numcon_subl;
-	char * q;
 	Sentence sent = linkage->sent;
 
 	ctxt->phrase_ss = string_set_create();
@@ -1094,16 +1148,117 @@ static char * do_print_flat_constituents(con_context_t *ctxt, Linkage linkage)
 	assert (numcon_total < ctxt->conlen, "Too many constituents (e)");
 	numcon_total = last_minute_fixes(ctxt, linkage, numcon_total);
 	assert (numcon_total < ctxt->conlen, "Too many constituents (f)");
-	q = exprint_constituent_structure(ctxt, linkage, numcon_total);
+
+	return numcon_total;
+}
+
+static void constituents_done(con_context_t *ctxt, Linkage linkage)
+{
 	string_set_delete(ctxt->phrase_ss);
 	ctxt->phrase_ss = NULL;
 
-	post_process_free_data(&sent->constituent_pp->pp_data);
+	post_process_free_data(&linkage->sent->constituent_pp->pp_data);
+}
 
-	return q;
+static CNode * make_CNode(const char *q)
+{
+	CNode * cn;
+	cn = (CNode *) malloc(sizeof(CNode));
+	cn->label = strdup(q);
+	cn->child = cn->next = (CNode *) NULL;
+	cn->next = (CNode *) NULL;
+	cn->start = cn->end = -1;
+	return cn;
 }
 
-static char * print_flat_constituents(Linkage linkage)
+/**
+ * Add node m as the last child of the node n.
+ */
+static void add_child(CNode *n, CNode **last_child, CNode *m)
+{
+	if (n->child == NULL)
+		n->child = m;
+	else
+		(*last_child)->next = m;
+	*last_child = m;
+}
+
+/* The state of build_constituent_tree(). */
+typedef struct
+{
+	CNode **open;         /* Stack of the currently open nodes */
+	CNode **last_child;   /* ... and their last child */
+	int depth;
+	CNode *root;
+	bool closed;          /* The root node got closed */
+} tree_builder;
+
+static void tree_open(void *data, const char *type)
+{
+	tree_builder *tb = data;
+	CNode *m = make_CNode(type);
+
+	if (NULL == tb->root)
+		tb->root = m;
+	else
+		add_child(tb->open[tb->depth-1], &tb->last_child[tb->depth-1], m);
+	tb->open[tb->depth] = m;
+	tb->last_child[tb->depth] = NULL;
+	tb->depth++;
+}
+
+static void tree_word(void *data, const char *word)
+{
+	tree_builder *tb = data;
+
+	/* Empty words have no token in the flat string. */
+	if ('\0' == word[0]) return;
+
+	assert(0 < tb->depth, "Illegal beginning of constituents");
+	add_child(tb->open[tb->depth-1], &tb->last_child[tb->depth-1],
+	          make_CNode(word));
+}
+
+static bool tree_close(void *data, const char *type)
+{
+	tree_builder *tb = data;
+
+	assert(0 < tb->depth, "Constituent tree: Constituent did not open");
+	tb->depth--;
+	assert(strcmp(type, tb->open[tb->depth]->label) == 0,
+	       "Constituent tree: Labels do not match.");
+	tb->closed = (0 == tb->depth);
+	return tb->closed;
+}
+
+/**
+ * Build the constituent tree directly from the constituents.
+ * The resulting tree is the same as the one that is got by parsing the
+ * output string of exprint_constituent_structure(): The tree root is
+ * the first constituent, and anything after it is ignored.
+ */
+static CNode *
+build_constituent_tree(con_context_t *ctxt, Linkage linkage, int numcon_total)
+{
+	static const constituent_walker tree_walker =
+		{ tree_open, tree_word, tree_close };
+	tree_builder tb = { 0 };
+
+	tb.open = alloca((numcon_total + 1) * sizeof(CNode *));
+	tb.last_child = alloca((numcon_total + 1) * sizeof(CNode *));
+
+	walk_constituents(ctxt, linkage, numcon_total, &tree_walker, &tb);
+
+	assert(tb.closed, "Constituent tree: Constituent did not close");
+	return tb.root;
+}
+
+/**
+ * Generate the constituents of the linkage, and output them as a flat
+ * bracketed string (if flat is not NULL) and/or as a tree (if tree is
+ * not NULL).
+ */
+static void linkage_constituents(Linkage linkage, char **flat, CNode **tree)
 {
 	size_t wts = linkage->num_words * sizeof(WType);
 	size_t cns = (linkage->num_links + linkage->num_words) * sizeof(constituent_t);
@@ -1116,62 +1271,20 @@ static char * print_flat_constituents(Linkage linkage)
 	ctxt.constituent = (constituent_t *) alloca(cns);
 	memset(ctxt.constituent, 0, cns);
 
-	return do_print_flat_constituents(&ctxt, linkage);
+	int numcon_total = generate_constituents(&ctxt, linkage);
+	if (NULL != flat)
+		*flat = exprint_constituent_structure(&ctxt, linkage, numcon_total);
+	if (NULL != tree)
+		*tree = build_constituent_tree(&ctxt, linkage, numcon_total);
+	constituents_done(&ctxt, linkage);
 }
 
-static CType token_type (char *token)
-{
-	if ((token[0] == OPEN_BRACKET) && (strlen(token) > 1))
-		return OPEN_TOK;
-	if ((strlen(token) > 1) && (token[strlen(token) - 1] == CLOSE_BRACKET))
-		return CLOSE_TOK;
-	return WORD_TOK;
-}
-
-static CNode * make_CNode(char *q)
-{
-	CNode * cn;
-	cn = (CNode *) malloc(sizeof(CNode));
-	cn->label = strdup(q);
-	cn->child = cn->next = (CNode *) NULL;
-	cn->next = (CNode *) NULL;
-	cn->start = cn->end = -1;
-	return cn;
-}
-
-static CNode * parse_string(CNode * n, char **saveptr)
+static char * print_flat_constituents(Linkage linkage)
 {
 	char *q;
-	CNode *m, *last_child=NULL;
-
-	while ((q = strtok_r(NULL, " ", saveptr))) {
-		switch (token_type(q)) {
-		case CLOSE_TOK :
-			q[strlen(q)-1]='\0';
-			assert(strcmp(q, n->label)==0,
-				   "Constituent tree: Labels do not match.");
-			return n;
-			break;
-		case OPEN_TOK:
-			m = make_CNode(q+1);
-			m = parse_string(m, saveptr);
-			break;
-		case WORD_TOK:
-			m = make_CNode(q);
-			break;
-		default:
-			assert(0, "Constituent tree: Illegal token type");
-		}
-		if (n->child == NULL) {
-			last_child = n->child = m;
-		}
-		else {
-			last_child->next = m;
-			last_child = m;
-		}
-	}
-	assert(0, "Constituent tree: Constituent did not close");
-	return NULL;
+
+	linkage_constituents(linkage, &q, NULL);
+	return q;
 }
 
 static void print_tree(dyn_str * cs, int indent, CNode * n, int o1, int o2)
@@ -1264,17 +1377,10 @@ static int assign_spans(CNode * n, int start)
 
 static CNode * linkage_constituent_tree(Linkage linkage)
 {
-	char *p, *q, *saveptr;
 	CNode * root;
 
-	p = print_flat_constituents(linkage);
-
-	q = strtok_r(p, " ", &saveptr);
-	assert(token_type(q) == OPEN_TOK, "Illegal beginning of string");
-	root = make_CNode(q+1);
-	root = parse_string(root, &saveptr);
+	linkage_constituents(linkage, NULL, &root);
 	assign_spans(root, 0);
-	free(p);
 	return root;
 }
 
@@ -14,14 +14,20 @@
 /* stuff for transforming a dictionary entry into a disjunct list */
 
 #include <math.h>
+#include <string.h>
+#include "api-structures.h"                // for Sentence_s
 #include "build-disjuncts.h"
 #include "connectors.h"
 //#include "dict-common/dict-api.h"        // for print_expression
+#include "dict-common/dict-common.h"       // for X_node_struct
 #include "dict-common/dict-structures.h"   // for Exp_struct
 #include "disjunct-utils.h"
+#include "tokenize/word-structures.h"      // for Word_struct
 #include "utilities.h"
 
-/* Temporary connectors used while converting expressions into disjunct lists */
+/* Temporary connectors used while converting expressions into disjunct
+ * lists. They are not changed after they are built, so the connector
+ * lists of different clauses can share their tails. */
 typedef struct Tconnector_struct Tconnector;
 struct Tconnector_struct
 {
@@ -34,40 +40,24 @@ struct Tconnector_struct
 typedef struct clause_struct Clause;
 struct clause_struct
 {
-	Clause * next;
 	double cost;
 	double maxcost;
 	Tconnector * c;
 };
 
-static void free_Tconnectors(Tconnector *e)
+/* The clauses of an expression. */
+typedef struct
 {
-	Tconnector * n;
-	for(;e != NULL; e=n)
-	{
-		n = e->next;
-		xfree((char *)e, sizeof(Tconnector));
-	}
-}
-
-static void free_clause_list(Clause *c)
-{
-	Clause *c1;
-	while (c != NULL)
-	{
-		c1 = c->next;
-		free_Tconnectors(c->c);
-		xfree((char *)c, sizeof(Clause));
-		c = c1;
-	}
-}
+	Clause *cl;
+	size_t num;
+} Clause_list;
 
 /**
  * reverse the order of the list e.  destructive
  */
-static Tconnector * Treverse(Tconnector *e)
+static Connector * reverse(Connector *e)
 {
-	Tconnector * head, *x;
+	Connector * head, *x;
 	head = NULL;
 	while (e != NULL) {
 		x = e->next;
@@ -78,52 +68,194 @@ static Tconnector * Treverse(Tconnector *e)
 	return head;
 }
 
+/* ======================================================== */
+/* Memoized expansion of expressions into clauses.
+ *
+ * The expressions of a word often have identical sub-expressions: The
+ * same dictionary macro is typically used under several OR branches of
+ * a verb expression, and the dictionary entries of a word use the same
+ * macros. Since the sentence expressions are copies of the dictionary
+ * expressions (which get pruned), such sub-expressions are identified
+ * by their structure: A node is keyed by its type and cost, and by its
+ * connector or the memo entries of its children. Hence identical
+ * sub-expressions get the same memo entry, and their clauses (including
+ * the cross-products of AND nodes) are built only once per word.
+ *
+ * The clauses don't depend on the cost cutoff. It is applied as a
+ * filter when the disjuncts are built from the clauses. */
+
+typedef struct
+{
+	const Exp *e;            /* The first node of this sub-expression */
+	unsigned int child;      /* Start of its children in child_id[] */
+	unsigned int num_child;
+	unsigned int hash;
+	Clause_list clauses;
+} clause_memo_entry;
+
+typedef struct
+{
+	clause_memo_entry *entry;
+	size_t num_entries;
+	size_t entries_size;
+	unsigned int *table;     /* Entry index + 1 by hash; 0 for empty */
+	size_t table_size;       /* A power of 2 */
+	unsigned int *child_id;  /* The children of the entries */
+	size_t num_child_ids;
+	size_t child_ids_size;
+	Pool_desc *Tconnector_pool;
+	size_t num_nodes;        /* Number of nodes expanded (for debug) */
+} clause_memo;
+
+static void clause_memo_init(clause_memo *cm)
+{
+	memset(cm, 0, sizeof(*cm));
+	cm->table_size = 256;
+	cm->table = calloc(cm->table_size, sizeof(*cm->table));
+	cm->Tconnector_pool = pool_new(__func__, "Tconnector",
+	                   /*num_elements*/1024, sizeof(Tconnector),
+	                   /*zero_out*/false, /*align*/false, /*exact*/false);
+}
+
+static void clause_memo_delete(clause_memo *cm)
+{
+	for (size_t i = 0; i < cm->num_entries; i++)
+		free(cm->entry[i].clauses.cl);
+	free(cm->entry);
+	free(cm->table);
+	free(cm->child_id);
+	pool_delete(cm->Tconnector_pool);
+}
+
+static unsigned int memo_hash(const Exp *e, const unsigned int *child,
+                              size_t n)
+{
+	unsigned int h = e->type * 0x9e3779b9u;
+
+	h = h * 31 + (unsigned int)(int)(e->cost * 1000);
+	if (CONNECTOR_type == e->type)
+	{
+		h = h * 31 + (unsigned int)((uintptr_t)e->u.condesc / sizeof(condesc_t));
+		h = h * 31 + (unsigned char)e->dir;
+		h = h * 31 + e->multi;
+	}
+	else
+	{
+		for (size_t i = 0; i < n; i++)
+			h = (h ^ child[i]) * 0x01000193u;
+	}
+
+	return h ^ (h >> 15);
+}
+
+static bool memo_equal(const clause_memo *cm, const clause_memo_entry *me,
+                       const Exp *e, const unsigned int *child, size_t n)
+{
+	if (me->e->type != e->type) return false;
+	if (me->e->cost != e->cost) return false;
+
+	if (CONNECTOR_type == e->type)
+	{
+		return (me->e->u.condesc == e->u.condesc) &&
+		       (me->e->dir == e->dir) && (me->e->multi == e->multi);
+	}
+
+	if (me->num_child != n) return false;
+	return (0 == memcmp(&cm->child_id[me->child], child, n * sizeof(*child)));
+}
+
+static void memo_table_grow(clause_memo *cm)
+{
+	free(cm->table);
+	cm->table_size *= 2;
+	cm->table = calloc(cm->table_size, sizeof(*cm->table));
+
+	for (size_t i = 0; i < cm->num_entries; i++)
+	{
+		size_t h = cm->entry[i].hash & (cm->table_size - 1);
+		while (0 != cm->table[h]) h = (h + 1) & (cm->table_size - 1);
+		cm->table[h] = (unsigned int)i + 1;
+	}
+}
+
 /**
- * reverse the order of the list e.  destructive
+ * Return the table slot of the memo entry of e, whose children have
+ * the memo entries child[0..n-1]. The slot is 0 if there is no such
+ * entry yet.
  */
-static Connector * reverse(Connector *e)
+static unsigned int *memo_lookup(clause_memo *cm, const Exp *e,
+                                 const unsigned int *child, size_t n,
+                                 unsigned int hash)
 {
-	Connector * head, *x;
-	head = NULL;
-	while (e != NULL) {
-		x = e->next;
-		e->next = head;
-		head = e;
-		e = x;
+	if (2 * (cm->num_entries + 1) > cm->table_size) memo_table_grow(cm);
+
+	size_t h = hash & (cm->table_size - 1);
+	for (; 0 != cm->table[h]; h = (h + 1) & (cm->table_size - 1))
+	{
+		const clause_memo_entry *me = &cm->entry[cm->table[h] - 1];
+		if ((me->hash == hash) && memo_equal(cm, me, e, child, n))
+			break;
 	}
-	return head;
+
+	return &cm->table[h];
+}
+
+static unsigned int memo_add(clause_memo *cm, const Exp *e,
+                             const unsigned int *child, size_t n,
+                             unsigned int hash, Clause_list clauses)
+{
+	if (cm->num_entries == cm->entries_size)
+	{
+		cm->entries_size = (0 == cm->entries_size) ? 256 : 2 * cm->entries_size;
+		cm->entry = realloc(cm->entry, cm->entries_size * sizeof(*cm->entry));
+	}
+	if (cm->num_child_ids + n > cm->child_ids_size)
+	{
+		cm->child_ids_size = MAX(2 * cm->child_ids_size, cm->num_child_ids + n);
+		cm->child_id = realloc(cm->child_id,
+		                       cm->child_ids_size * sizeof(*cm->child_id));
+	}
+
+	clause_memo_entry *me = &cm->entry[cm->num_entries];
+	me->e = e;
+	me->child = (unsigned int)cm->num_child_ids;
+	me->num_child = (unsigned int)n;
+	me->hash = hash;
+	me->clauses = clauses;
+	if (0 != n)
+		memcpy(&cm->child_id[cm->num_child_ids], child, n * sizeof(*child));
+	cm->num_child_ids += n;
+
+	return (unsigned int)cm->num_entries++;
 }
 
 /**
  * Builds a new list of connectors that is the catenation of e1 with e2.
- * does not effect lists e1 or e2.   Order is maintained.
+ * Order is maintained. The connectors of e1 are copied, and the
+ * resulting list shares e2.
  */
-static Tconnector * catenate(Tconnector * e1, Tconnector * e2)
+static Tconnector * catenate(clause_memo *cm, Tconnector * e1, Tconnector * e2)
 {
-	Tconnector * e, * head;
-	head = NULL;
+	Tconnector * head;
+	Tconnector ** tail = &head;
+
 	for (;e1 != NULL; e1 = e1->next) {
-		e = (Tconnector *) xalloc(sizeof(Tconnector));
+		Tconnector * e = pool_alloc(cm->Tconnector_pool);
 		*e = *e1;
-		e->next = head;
-		head = e;
+		*tail = e;
+		tail = &e->next;
 	}
-	for (;e2 != NULL; e2 = e2->next) {
-		e = (Tconnector *) xalloc(sizeof(Tconnector));
-		*e = *e2;
-		e->next = head;
-		head = e;
-	}
-	return Treverse(head);
+	*tail = e2;
+	return head;
 }
 
 /**
  * build the connector for the terminal node n
  */
-static Tconnector * build_terminal(Exp * e)
+static Tconnector * build_terminal(clause_memo *cm, Exp * e)
 {
 	Tconnector * c;
-	c = (Tconnector *) xalloc(sizeof(Tconnector));
+	c = pool_alloc(cm->Tconnector_pool);
 	c->condesc = e->u.condesc;
 	c->multi = e->multi;
 	c->dir = e->dir;
@@ -131,74 +263,110 @@ static Tconnector * build_terminal(Exp * e)
 	return c;
 }
 
-/**
- * Build the clause for the expression e.  Does not change e
- */
-static Clause * build_clause(Exp *e)
+/* The clause order of the AND and OR nodes below is the same as that
+ * of building the clause lists by prepending (as it was done before
+ * the clauses got memoized), so the resulting disjunct order is kept. */
+
+static Clause_list and_clauses(clause_memo *cm, const unsigned int *child,
+                               size_t n)
 {
-	Clause *c = NULL, *c1, *c2, *c3, *c4, *c_head;
-	E_list * e_list;
+	Clause_list c1 = { .cl = malloc(sizeof(Clause)), .num = 1 };
+	c1.cl[0] = (Clause){ .cost = 0.0, .maxcost = 0.0, .c = NULL };
 
-	assert(e != NULL, "build_clause called with null parameter");
-	if (e->type == AND_type)
+	for (size_t i = 0; i < n; i++)
 	{
-		c1 = (Clause *) xalloc(sizeof (Clause));
-		c1->c = NULL;
-		c1->next = NULL;
-		c1->cost = 0.0;
-		c1->maxcost = 0.0;
-		for (e_list = e->u.l; e_list != NULL; e_list = e_list->next)
+		Clause_list c2 = cm->entry[child[i]].clauses;
+		size_t num = c1.num * c2.num;
+		Clause *c = malloc(MAX(num, 1) * sizeof(Clause));
+		Clause *cp = c + num;
+
+		for (Clause *c3 = c1.cl; c3 < c1.cl + c1.num; c3++)
 		{
-			c2 = build_clause(e_list->e);
-			c_head = NULL;
-			for (c3 = c1; c3 != NULL; c3 = c3->next)
+			for (Clause *c4 = c2.cl; c4 < c2.cl + c2.num; c4++)
 			{
-				for (c4 = c2; c4 != NULL; c4 = c4->next)
-				{
-					c = (Clause *) xalloc(sizeof (Clause));
-					c->cost = c3->cost + c4->cost;
-					c->maxcost = MAX(c3->maxcost,c4->maxcost);
-					c->c = catenate(c3->c, c4->c);
-					c->next = c_head;
-					c_head = c;
-				}
+				cp--;
+				cp->cost = c3->cost + c4->cost;
+				cp->maxcost = MAX(c3->maxcost,c4->maxcost);
+				cp->c = catenate(cm, c3->c, c4->c);
 			}
-			free_clause_list(c1);
-			free_clause_list(c2);
-			c1 = c_head;
 		}
-		c = c1;
+		free(c1.cl);
+		c1 = (Clause_list){ .cl = c, .num = num };
+	}
+
+	return c1;
+}
+
+static Clause_list or_clauses(clause_memo *cm, const unsigned int *child,
+                              size_t n)
+{
+	size_t num = 0;
+	for (size_t i = 0; i < n; i++)
+		num += cm->entry[child[i]].clauses.num;
+
+	Clause *c = malloc(MAX(num, 1) * sizeof(Clause));
+	Clause *cp = c + num;
+	for (size_t i = 0; i < n; i++)
+	{
+		Clause_list c1 = cm->entry[child[i]].clauses;
+		for (Clause *c3 = c1.cl; c3 < c1.cl + c1.num; c3++)
+			*--cp = *c3;
+	}
+
+	return (Clause_list){ .cl = c, .num = num };
+}
+
+/**
+ * Build the clauses for the expression e, and return their memo entry.
+ * Does not change e.
+ */
+static unsigned int build_clause(clause_memo *cm, Exp *e)
+{
+	size_t n = 0;
+
+	assert(e != NULL, "build_clause called with null parameter");
+	cm->num_nodes++;
+	if (e->type != CONNECTOR_type)
+	{
+		for (E_list *l = e->u.l; l != NULL; l = l->next) n++;
+	}
+
+	unsigned int *child = alloca((n + 1) * sizeof(*child));
+	if (e->type != CONNECTOR_type)
+	{
+		unsigned int *cp = child;
+		for (E_list *l = e->u.l; l != NULL; l = l->next)
+			*cp++ = build_clause(cm, l->e);
+	}
+
+	unsigned int hash = memo_hash(e, child, n);
+	unsigned int *slot = memo_lookup(cm, e, child, n, hash);
+	if (0 != *slot) return *slot - 1;
+
+	Clause_list c;
+	if (e->type == AND_type)
+	{
+		c = and_clauses(cm, child, n);
 	}
 	else if (e->type == OR_type)
 	{
-		/* we'll catenate the lists of clauses */
-		c = NULL;
-		for (e_list = e->u.l; e_list != NULL; e_list = e_list->next)
-		{
-			c1 = build_clause(e_list->e);
-			while(c1 != NULL) {
-				c3 = c1->next;
-				c1->next = c;
-				c = c1;
-				c1 = c3;
-			}
-		}
+		c = or_clauses(cm, child, n);
 	}
 	else if (e->type == CONNECTOR_type)
 	{
-		c = (Clause *) xalloc(sizeof(Clause));
-		c->c = build_terminal(e);
-		c->cost = 0.0;
-		c->maxcost = 0.0;
-		c->next = NULL;
+		c.cl = malloc(sizeof(Clause));
+		c.num = 1;
+		c.cl[0].c = build_terminal(cm, e);
+		c.cl[0].cost = 0.0;
+		c.cl[0].maxcost = 0.0;
 	}
 	else
 	{
 		assert(false, "an expression node with no type");
 	}
 
-	/* c now points to the list of clauses */
-	for (c1 = c; c1 != NULL; c1 = c1->next)
+	/* c now has the clauses */
+	for (Clause *c1 = c.cl; c1 < c.cl + c.num; c1++)
 	{
 		c1->cost += e->cost;
 		/* c1->maxcost = MAX(c1->maxcost,e->cost);  */
@@ -209,7 +377,10 @@ static Clause * build_clause(Exp *e)
 		 */
 		c1->maxcost += e->cost;
 	}
-	return c;
+
+	unsigned int id = memo_add(cm, e, child, n, hash, c);
+	*slot = id + 1;
+	return id;
 }
 
 /**
@@ -240,12 +411,12 @@ static Connector * extract_connectors(Tconnector *e, int c, Parse_Options opts)
  * string is the print name of word that generated this disjunct.
  */
 static Disjunct *
-build_disjunct(Clause * cl, const char * string, double cost_cutoff,
+build_disjunct(Clause_list *c, const char * string, double cost_cutoff,
                Parse_Options opts)
 {
 	Disjunct *dis, *ndis;
 	dis = NULL;
-	for (; cl != NULL; cl = cl->next)
+	for (Clause *cl = c->cl; cl < c->cl + c->num; cl++)
 	{
 		if (cl->maxcost <= cost_cutoff)
 		{
@@ -264,17 +435,315 @@ build_disjunct(Clause * cl, const char * string, double cost_cutoff,
 Disjunct * build_disjuncts_for_exp(Exp* exp, const char *word,
                                    double cost_cutoff, Parse_Options opts)
 {
-	Clause *c ;
+	clause_memo cm;
 	Disjunct * dis;
+
+	clause_memo_init(&cm);
 	// print_expression(exp);  printf("\n");
-	c = build_clause(exp);
-	// print_clause_list(c);
-	dis = build_disjunct(c, word, cost_cutoff, opts);
+	unsigned int id = build_clause(&cm, exp);
+	// print_clause_list(&cm.entry[id].clauses);
+	dis = build_disjunct(&cm.entry[id].clauses, word, cost_cutoff, opts);
 	// print_disjunct_list(dis);
-	free_clause_list(c);
+	clause_memo_delete(&cm);
 	return dis;
 }
 
+/* ======================================================== */
+/* Building the sentence disjuncts into one memory block.
+ *
+ * The clauses of all the sentence expressions are built first, so the
+ * exact number of disjuncts and connectors is known. Then the disjuncts
+ * and connectors are emitted directly into a single memory block, which
+ * is kept until the sentence is deleted. Disjuncts and connectors that
+ * get eliminated later (duplicates, pruning) are just unlinked and not
+ * freed.
+ *
+ * The memory block consists of a disjunct section followed by a
+ * connector section. The block and the connector section start on a
+ * cache-line boundary, so that an integral number of connectors fits
+ * in each cache line (the Connector size is a power of 2). */
+
+static size_t count_clause_connectors(Clause *cl)
+{
+	size_t n = 0;
+	for (Tconnector *t = cl->c; t != NULL; t = t->next) n++;
+	return n;
+}
+
+/**
+ * Emit the connectors of the Tconnector list e whose direction is dir.
+ * The order of the resulting list is reversed relative to e, as the
+ * order of the connectors in a disjunct is from the word outward.
+ */
+static Connector *emit_connectors(Tconnector *e, int dir, Connector **cblock,
+                                  Parse_Options opts)
+{
+	Connector *head = NULL;
+
+	for (; e != NULL; e = e->next)
+	{
+		if (e->dir != dir) continue;
+
+		Connector *c = (*cblock)++;
+		c->desc = e->condesc;
+		c->multi = e->multi;
+		c->nearest_word = 0;
+		c->originating_gword = NULL;
+		set_connector_length_limit(c, opts);
+		c->next = head;
+		head = c;
+	}
+
+	return head;
+}
+
+/**
+ * Emit the disjuncts of the clause list cl whose maxcost is within the
+ * cost cutoff. The disjunct order is the reverse of the clause order.
+ */
+static Disjunct *emit_disjuncts(Clause_list *c, const char *string,
+                                double cost_cutoff,
+                                Disjunct **dblock, Connector **cblock,
+                                Parse_Options opts)
+{
+	Disjunct *dis = NULL;
+
+	for (Clause *cl = c->cl; cl < c->cl + c->num; cl++)
+	{
+		if (cl->maxcost > cost_cutoff) continue;
+
+		Disjunct *ndis = (*dblock)++;
+		ndis->left = emit_connectors(cl->c, '-', cblock, opts);
+		ndis->right = emit_connectors(cl->c, '+', cblock, opts);
+		ndis->word_string = string;
+		ndis->cost = cl->cost;
+		ndis->originating_gword = NULL;
+		ndis->next = dis;
+		dis = ndis;
+	}
+
+	return dis;
+}
+
+static int cost_compare(const void *a, const void *b)
+{
+	double c1 = *(const double *)a;
+	double c2 = *(const double *)b;
+
+	return (c1 > c2) - (c1 < c2);
+}
+
+/**
+ * Return the cost cutoff that leaves at most max_disjuncts of the
+ * clauses whose maxcost is in \p maxcost[0..n-1], keeping those of the
+ * lowest maxcost. Clauses of an equal maxcost are kept or dropped
+ * together, but the clauses of the lowest maxcost are always kept.
+ * The array is sorted in place.
+ */
+static double budget_cost_cutoff(double *maxcost, size_t n,
+                                 size_t max_disjuncts)
+{
+	qsort(maxcost, n, sizeof(*maxcost), cost_compare);
+
+	/* maxcost[i] is the lowest maxcost to be dropped. */
+	size_t i = max_disjuncts;
+	while ((0 < i) && (maxcost[i-1] == maxcost[i])) i--;
+	if (0 == i) return maxcost[0];
+	return maxcost[i-1];
+}
+
+/* The per-word state of build_sentence_disjuncts(). */
+typedef struct
+{
+	clause_memo memo;    /* The clauses of the word sub-expressions */
+	unsigned int *xcl;   /* The memo entries of the word expressions */
+	size_t num_x;        /* ... and their number */
+	double cost_cutoff;  /* The cost cutoff of the word */
+	size_t dcnt;         /* Number of disjuncts within the cutoff */
+	size_t ccnt;         /* ... and their number of connectors */
+	size_t dstart;       /* Their start index in the disjunct section */
+	size_t cstart;       /* ... and in the connector section */
+	bool trimmed;        /* The cutoff has been lowered to the budget */
+} word_build_t;
+
+typedef struct
+{
+	Sentence sent;
+	Parse_Options opts;
+	double cost_cutoff;
+	size_t max_disjuncts;
+	word_build_t *wb;
+	Disjunct *dblock;
+	Connector *cblock;
+} build_context_t;
+
+/**
+ * Build the clauses of the expressions of word w, and count the
+ * disjuncts and connectors that it will have.
+ */
+static void build_word_clauses(size_t w, void *arg)
+{
+	build_context_t *bc = arg;
+	word_build_t *wb = &bc->wb[w];
+	double cost_cutoff = bc->cost_cutoff;
+	size_t max_disjuncts = bc->max_disjuncts;
+	clause_memo *cm = &wb->memo;
+	unsigned int *xcl = wb->xcl;
+	size_t n = 0;
+
+	clause_memo_init(cm);
+	for (X_node *x = bc->sent->word[w].x; x != NULL; x = x->next)
+	{
+		*xcl = build_clause(cm, x->exp);
+		Clause_list *c = &cm->entry[*xcl].clauses;
+		for (Clause *cl = c->cl; cl < c->cl + c->num; cl++)
+			if (cl->maxcost <= cost_cutoff) n++;
+		xcl++;
+	}
+	lgdebug(+6, "Word %zu: %zu expression nodes, %zu distinct\n",
+	        w, cm->num_nodes, cm->num_entries);
+
+	wb->cost_cutoff = cost_cutoff;
+	wb->trimmed = false;
+	if ((0 != max_disjuncts) && (max_disjuncts < n))
+	{
+		double *maxcost = malloc(n * sizeof(double));
+
+		n = 0;
+		for (unsigned int *x = wb->xcl; x < xcl; x++)
+		{
+			Clause_list *c = &cm->entry[*x].clauses;
+			for (Clause *cl = c->cl; cl < c->cl + c->num; cl++)
+				if (cl->maxcost <= cost_cutoff) maxcost[n++] = cl->maxcost;
+		}
+
+		wb->cost_cutoff = budget_cost_cutoff(maxcost, n, max_disjuncts);
+		wb->trimmed = true;
+		free(maxcost);
+		lgdebug(+5, "Word %zu: %zu disjuncts, cost cutoff %.3f\n",
+		        w, n, wb->cost_cutoff);
+	}
+
+	wb->dcnt = 0;
+	wb->ccnt = 0;
+	for (unsigned int *x = wb->xcl; x < xcl; x++)
+	{
+		Clause_list *c = &cm->entry[*x].clauses;
+		for (Clause *cl = c->cl; cl < c->cl + c->num; cl++)
+		{
+			if (cl->maxcost > wb->cost_cutoff) continue;
+			wb->dcnt++;
+			wb->ccnt += count_clause_connectors(cl);
+		}
+	}
+}
+
+/**
+ * Emit the disjuncts of word w into its part of the memory block,
+ * and free its clauses.
+ */
+static void emit_word_disjuncts(size_t w, void *arg)
+{
+	build_context_t *bc = arg;
+	word_build_t *wb = &bc->wb[w];
+	Disjunct *dblock = bc->dblock + wb->dstart;
+	Connector *cblock = bc->cblock + wb->cstart;
+	unsigned int *xcl = wb->xcl;
+	Disjunct *d = NULL;
+
+	for (X_node *x = bc->sent->word[w].x; x != NULL; x = x->next)
+	{
+		Disjunct *dx = emit_disjuncts(&wb->memo.entry[*xcl].clauses, x->string,
+		                              wb->cost_cutoff, &dblock, &cblock, bc->opts);
+		word_record_in_disjunct(x->word, dx);
+		d = catenate_disjuncts(dx, d);
+		xcl++;
+	}
+	clause_memo_delete(&wb->memo);
+	bc->sent->word[w].d = d;
+}
+
+/**
+ * Turn sentence expressions into disjuncts.
+ * Sentence expressions must have been built, before calling this routine.
+ *
+ * If max_disjuncts is not 0, it is the disjunct budget of each word:
+ * The cost cutoff of a word which has more disjuncts is lowered so
+ * that only (about) max_disjuncts of its lowest-cost disjuncts are
+ * built. Return the number of the words whose cutoff has been lowered.
+ *
+ * The words are independent here, so if opts->threads > 1 they are
+ * processed concurrently. Each word emits its disjuncts into its own
+ * part of the memory block, which is determined in advance by the
+ * disjunct and connector counts of the preceding words. Hence the
+ * resulting disjuncts are the same as when building in a single thread.
+ */
+size_t build_sentence_disjuncts(Sentence sent, double cost_cutoff,
+                                size_t max_disjuncts, Parse_Options opts)
+{
+	size_t num_x = 0;
+	size_t dcnt = 0;
+	size_t ccnt = 0;
+	size_t num_trimmed = 0;
+	int nthreads = (NULL == opts) ? 1 : opts->threads;
+	word_build_t *wb = malloc(sent->length * sizeof(word_build_t));
+
+	for (WordIdx w = 0; w < sent->length; w++)
+	{
+		wb[w].num_x = 0;
+		for (X_node *x = sent->word[w].x; x != NULL; x = x->next)
+			wb[w].num_x++;
+		num_x += wb[w].num_x;
+	}
+
+	unsigned int *clauses = malloc(num_x * sizeof(*clauses));
+	unsigned int *xcl = clauses;
+	for (WordIdx w = 0; w < sent->length; w++)
+	{
+		wb[w].xcl = xcl;
+		xcl += wb[w].num_x;
+	}
+
+	build_context_t bc =
+	{
+		.sent = sent,
+		.opts = opts,
+		.cost_cutoff = cost_cutoff,
+		.max_disjuncts = max_disjuncts,
+		.wb = wb,
+	};
+	parallel_for(sent->length, nthreads, build_word_clauses, &bc);
+
+	for (WordIdx w = 0; w < sent->length; w++)
+	{
+		wb[w].dstart = dcnt;
+		wb[w].cstart = ccnt;
+		dcnt += wb[w].dcnt;
+		ccnt += wb[w].ccnt;
+		if (wb[w].trimmed) num_trimmed++;
+	}
+
+	size_t dsize = ALIGN(dcnt * sizeof(Disjunct), CACHE_LINE_SIZE);
+	size_t csize = ALIGN(ccnt * sizeof(Connector), CACHE_LINE_SIZE);
+	size_t memblock_sz = MAX(dsize + csize, CACHE_LINE_SIZE);
+	void *memblock = aligned_alloc(CACHE_LINE_SIZE, memblock_sz);
+	bc.dblock = memblock;
+	bc.cblock = (Connector *)((char *)memblock + dsize);
+
+	free_sentence_disjuncts(sent);
+	sent->disjuncts_connectors_memblock = memblock;
+	sent->disjuncts_connectors_memblock_sz = memblock_sz;
+
+	parallel_for(sent->length, nthreads, emit_word_disjuncts, &bc);
+
+	free(clauses);
+	free(wb);
+	lgdebug(+5, "%zu disjuncts, %zu connectors (%zu bytes)\n",
+	        dcnt, ccnt, memblock_sz);
+
+	return num_trimmed;
+}
+
 #ifdef DEBUG
 /* Misc printing functions, useful for debugging */
 
@@ -288,9 +757,9 @@ static void print_Tconnector_list(Tconnector * e)
 	}
 }
 
-GNUC_UNUSED static void print_clause_list(Clause * c)
+GNUC_UNUSED static void print_clause_list(Clause_list * cl)
 {
-	for (;c != NULL; c=c->next) {
+	for (Clause *c = cl->cl; c < cl->cl + cl->num; c++) {
 		printf("  Clause: ");
 		printf("(%4.2f, %4.2f) ", c->cost, c->maxcost);
 		print_Tconnector_list(c->c);
@@ -18,6 +18,7 @@
 #include "link-includes.h"
 
 Disjunct * build_disjuncts_for_exp(Exp*, const char*, double cost_cutoff, Parse_Options opts);
+size_t build_sentence_disjuncts(Sentence, double cost_cutoff, size_t max_disjuncts, Parse_Options opts);
 
 #ifdef DEBUG
 void prt_exp(Exp *, int);
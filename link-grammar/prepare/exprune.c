@@ -43,81 +43,46 @@
 		free(e);\
 	}
 
-typedef struct connector_table_s connector_table;
-struct connector_table_s
+/* The connector table has one bucket per connector uc_num. Each bucket
+ * is a contiguous array of the distinct lower-case parts (as their
+ * lc_letters/lc_mask encoding) of the connectors that are currently in
+ * the set, together with the farthest word that each of them can
+ * reach. Looking up a connector is thus a linear scan over a few
+ * adjacent elements, which needs no pointer chasing. The arrays are
+ * reused on each pass, and freed only at the end of the expression
+ * pruning. Only the buckets that have been used in a pass are reset
+ * at its end (their uc_nums are kept in the "touched" array). */
+typedef struct
 {
-	condesc_t *condesc;
-	connector_table *next;
+	lc_enc_t lc_letters;
+	lc_enc_t lc_mask;
 	int farthest_word;
-};
+} ct_element;
 
-#define CT_BLKSIZE 512
-/* The connector table elements are allocated in a kind of an unrolled
- * linked list with fixed blocks, when the first block is pre-allocated
- * (this simplifies the handling). Additional blocks are
- * dynamically allocated, but they are rarely needed. The existing
- * allocation is reused on each pass, and freed only at the end of the
- * expression pruning. */
-// connector_table_element-> ... CT_BLKSIZE-1 elements
-//                           ...
-//                           ...
-//                           block connecting element ->---+
-//                                                         |
-// (additional block)        CT_BLKSIZE-1 elements     <---+
-//                           ...
-// current_element        -> ...
-//                           ...
-// end_current_block      -> block connecting element ->---+
-//                                                         |
-// (additional block)        CT_BLKSIZE-1 elements     <---+
-//                           ...
-//                           ...
-//                           ...
-//                           block connecting element
+typedef struct
+{
+	ct_element *e;
+	unsigned int num;
+	unsigned int size;
+} connector_table;
 
 typedef struct exprune_context_s exprune_context;
 struct exprune_context_s
 {
-	connector_table **ct;
+	connector_table *ct;
 	size_t ct_size;
+	connector_hash_t *touched;
+	size_t num_touched;
 	Parse_Options opts;
-	connector_table *current_element;
-	connector_table *end_current_block;
-	connector_table connector_table_element[CT_BLKSIZE];
 };
 
-static connector_table *ct_element_new(exprune_context *ctxt)
-{
-	if (ctxt->current_element == ctxt->end_current_block)
-	{
-		if (ctxt->end_current_block->next == NULL)
-		{
-			connector_table *newblock =
-				malloc(CT_BLKSIZE * sizeof(*ctxt->current_element));
-			newblock[CT_BLKSIZE-1].next = NULL;
-			ctxt->end_current_block->next = newblock;
-		} /* else - reuse next block. */
-
-		ctxt->current_element = ctxt->end_current_block->next;
-		ctxt->end_current_block = &ctxt->current_element[CT_BLKSIZE-1];
-	}
-
-	return ctxt->current_element++;
-}
-
 static void free_connector_table(exprune_context *ctxt)
 {
-	connector_table *x;
-	connector_table *t = ctxt->connector_table_element[CT_BLKSIZE-1].next;
-
-	while (t != NULL)
-	{
-			 x = t[CT_BLKSIZE-1].next;
-			 free(t);
-			 t = x;
-	}
+	for (size_t i = 0; i < ctxt->ct_size; i++)
+		free(ctxt->ct[i].e);
 
 	free(ctxt->ct);
+	free(ctxt->touched);
 	ctxt->ct = NULL;
 	ctxt->ct_size = 0;
 }
@@ -138,6 +103,14 @@ static void free_connector_table(exprune_context *ctxt)
  * If an OR or AND type expression node has one child, we can replace it
  * by its child.  This, of course, is not really necessary, except for
  * performance(?).
+ *
+ * Note that the pruning results cannot be cached across sentences by
+ * word pairs (e.g. "the connectors of this determiner that can never
+ * connect to this verb"): A connector is dead only if no word in its
+ * direction (up to its length limit) can match it, which depends on all
+ * of these words. Facts about a single word pair are exact only for
+ * connectors of length limit 1 (e.g. YS, YP, PH, ZZZ in English), and
+ * the first pass finds these anyway. The same holds for power pruning.
  */
 
 static Exp* purge_Exp(Exp *);
@@ -234,25 +207,21 @@ static Exp* purge_Exp(Exp *e)
 	return e;
 }
 
-/**
- * This hash function only looks at the leading upper case letters of
- * the connector string, and the label fields.  This ensures that if two
- * strings match (formally), then they must hash to the same place.
- */
-static inline unsigned int hash_S(condesc_t * c)
-{
-	return c->uc_num;
-}
-
 /**
  * Returns TRUE if c can match anything in the set S (err. the connector table ct).
+ * Only connectors with the same uc_num can match, and for them the
+ * match is decided by their lower-case parts (see lc_easy_match()).
  */
-static inline bool matches_S(connector_table **ct, int w, condesc_t * c)
+static inline bool matches_S(connector_table *ct, int w, condesc_t * c)
 {
-	connector_table *e;
+	const connector_table *t = &ct[c->uc_num];
 
-	for (e = ct[hash_S(c)]; e != NULL; e = e->next)
+	/* Scan the most recently inserted elements first: they belong to
+	 * the nearest words, and so are the most likely ones to match. */
+	for (unsigned int i = t->num; i-- > 0; )
 	{
+		const ct_element *e = &t->e[i];
+
 		if (e->farthest_word <= 0)
 		{
 			if (w < -e->farthest_word) continue;
@@ -261,16 +230,17 @@ static inline bool matches_S(connector_table **ct, int w, condesc_t * c)
 		{
 			if (w > e->farthest_word) continue;
 		}
-		if (easy_match_desc(e->condesc, c)) return true;
+		lc_enc_t mask = e->lc_mask & c->lc_mask;
+		if (((e->lc_letters ^ c->lc_letters) & mask) == (mask & 1)) return true;
 	}
 	return false;
 }
 
 static void zero_connector_table(exprune_context *ctxt)
 {
-	memset(ctxt->ct, 0, sizeof(*ctxt->ct) * ctxt->ct_size);
-	ctxt->current_element = ctxt->connector_table_element;
-	ctxt->end_current_block = &ctxt->connector_table_element[CT_BLKSIZE-1];
+	for (size_t i = 0; i < ctxt->num_touched; i++)
+		ctxt->ct[ctxt->touched[i]].num = 0;
+	ctxt->num_touched = 0;
 }
 
 /**
@@ -278,7 +248,7 @@ static void zero_connector_table(exprune_context *ctxt)
  * in e that are not matched by anything in the current set.
  * Returns the number of connectors so marked.
  */
-static int mark_dead_connectors(connector_table **ct, int w, Exp * e, char dir)
+static int mark_dead_connectors(connector_table *ct, int w, Exp * e, char dir)
 {
 	int count;
 	count = 0;
@@ -310,28 +280,31 @@ static int mark_dead_connectors(connector_table **ct, int w, Exp * e, char dir)
  */
 static void insert_connector(exprune_context *ctxt, int farthest_word, condesc_t * c)
 {
-	unsigned int h;
-	connector_table *e;
-
-	h = hash_S(c);
+	connector_table *t = &ctxt->ct[c->uc_num];
+	ct_element *e;
 
-	for (e = ctxt->ct[h]; e != NULL; e = e->next)
+	for (e = t->e; e < t->e + t->num; e++)
 	{
-		if (c == e->condesc)
+		if ((e->lc_letters == c->lc_letters) && (e->lc_mask == c->lc_mask))
 		{
-			{
-				if (e->farthest_word < farthest_word) e->farthest_word = farthest_word;
-			}
+			if (e->farthest_word < farthest_word) e->farthest_word = farthest_word;
 			return;
 		}
 	}
 
-	e = ct_element_new(ctxt);
-	e->condesc = c;
+	if (t->num == 0) ctxt->touched[ctxt->num_touched++] = c->uc_num;
+	if (t->num == t->size)
+	{
+		t->size = (t->size == 0) ? 4 : 2 * t->size;
+		t->e = realloc(t->e, t->size * sizeof(*t->e));
+	}
+
+	e = &t->e[t->num++];
+	e->lc_letters = c->lc_letters;
+	e->lc_mask = c->lc_mask;
 	e->farthest_word = farthest_word;
-	e->next = ctxt->ct[h];
-	ctxt->ct[h] = e;
 }
+
 /**
  * Put into the set S all of the dir-pointing connectors still in e.
  * Return a list of allocated dummy connectors; these will need to be
@@ -414,9 +387,9 @@ void expression_prune(Sentence sent, Parse_Options opts)
 
 	ctxt.opts = opts;
 	ctxt.ct_size = sent->dict->contable.num_uc;
-	ctxt.ct = malloc(ctxt.ct_size * sizeof(*ctxt.ct));
-	zero_connector_table(&ctxt);
-	ctxt.end_current_block->next = NULL;
+	ctxt.ct = calloc(ctxt.ct_size, sizeof(*ctxt.ct));
+	ctxt.touched = malloc(ctxt.ct_size * sizeof(*ctxt.touched));
+	ctxt.num_touched = 0;
 
 	N_deleted = 1;  /* a lie to make it always do at least 2 passes */
 
@@ -432,12 +405,10 @@ void expression_prune(Sentence sent, Parse_Options opts)
 			for (x = sent->word[w].x; x != NULL; x = x->next)
 			{
 				DBG(pass, w, "l->r pass before marking");
-				N_deleted += mark_dead_connectors(ctxt.ct, w, x->exp, '-');
+				int N_marked = mark_dead_connectors(ctxt.ct, w, x->exp, '-');
 				DBG(pass, w, "l->r pass after marking");
-			}
-			for (x = sent->word[w].x; x != NULL; x = x->next)
-			{
-				DBG(pass, w, "l->r pass before purging");
+				if (N_marked == 0) continue; /* Nothing to purge. */
+				N_deleted += N_marked;
 				x->exp = purge_Exp(x->exp);
 				DBG(pass, w, "l->r pass after purging");
 			}
@@ -462,12 +433,10 @@ void expression_prune(Sentence sent, Parse_Options opts)
 			for (x = sent->word[w].x; x != NULL; x = x->next)
 			{
 				DBG(pass, w, "r->l pass before marking");
-				N_deleted += mark_dead_connectors(ctxt.ct, w, x->exp, '+');
+				int N_marked = mark_dead_connectors(ctxt.ct, w, x->exp, '+');
 				DBG(pass, w, "r->l pass after marking");
-			}
-			for (x = sent->word[w].x; x != NULL; x = x->next)
-			{
-				DBG(pass, w, "r->l pass before purging");
+				if (N_marked == 0) continue; /* Nothing to purge. */
+				N_deleted += N_marked;
 				x->exp = purge_Exp(x->exp);
 				DBG(pass, w, "r->l pass after purging");
 			}
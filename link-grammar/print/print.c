@@ -426,25 +426,26 @@ build_linkage_postscript_string(const Linkage linkage,
 
 #define HEIGHT_INC 10
 
-static void diagram_alloc_tmpmem(size_t **start, char ***pic, char ***xpic,
+/**
+ * Grow the link picture to max_height rows. The rows are kept in one
+ * block (*picmem) of row_size bytes per row, and (*pic)[i] points to
+ * row i. The new rows are set to num_cols blanks.
+ */
+static void diagram_alloc_tmpmem(char **picmem, char ***pic,
                                  size_t *cur_height, size_t max_height,
-                                 size_t max_bytes, size_t num_cols)
+                                 size_t row_size, size_t num_cols)
 {
-	assert(num_cols < max_bytes);
+	assert(num_cols < row_size);
 	assert(max_height > *cur_height);
 
-	*start = realloc(*start, max_height * sizeof(size_t));
+	*picmem = realloc(*picmem, max_height * row_size);
 	*pic = realloc(*pic, max_height * sizeof(char *));
-	*xpic = realloc(*xpic, max_height * sizeof(char *));
+
+	for (size_t i = 0; i < max_height; i++)
+		(*pic)[i] = *picmem + i * row_size;
 
 	for (size_t i = *cur_height; i < max_height; i++)
 	{
-		/* Allocate memory for both pic and xpic. */
-		char *picmem = malloc(max_bytes * 2 + 2);
-
-		(*pic)[i] = picmem;
-		(*xpic)[i] = picmem + max_bytes;
-
 		memset((*pic)[i], ' ', num_cols);
 		(*pic)[i][num_cols] = '\0';
 	}
@@ -452,18 +453,30 @@ static void diagram_alloc_tmpmem(size_t **start, char ***pic, char ***xpic,
 	*cur_height = max_height;
 }
 
-static void diagram_free_tmpmem(size_t *start, char **pic, char **xpic,
-                                size_t cur_height)
+/**
+ * Return the length of the given link (in words) if it is to be shown
+ * in the diagram, else 0.
+ */
+static unsigned int diagram_link_length(const Linkage linkage, LinkIdx j,
+                                        bool print_word_0, bool print_word_N,
+                                        unsigned int N_words_to_print)
 {
+	Link *lnk = &linkage->link_array[j];
 
-	for (size_t i = 0; i < cur_height; i++)
-		free(pic[i]);
+	assert (lnk->lw != SIZE_MAX);
+	if (NULL == lnk->link_name) return 0;
+	if (!print_word_0 && (lnk->lw == 0)) return 0;
+	/* Gets rid of the irrelevant link to the left wall */
+	if (!print_word_N && (lnk->rw == linkage->num_words-1)) return 0;
 
-	free(start);
-	free(pic);
-	free(xpic);
+	unsigned int link_length = lnk->rw - lnk->lw;
+	if (link_length >= N_words_to_print) return 0;
+
+	return link_length;
 }
 
+#define RIGHT_MARGIN 1
+
 /**
  * Print the indicated linkage into a utf8-diagram.
  * Works fine for general utf8 multi-byte sentences.
@@ -550,9 +563,8 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 	N_words_to_print = linkage->num_words;
 	if (!print_word_N) N_words_to_print--;
 
-	size_t *start = NULL;
+	char *picmem = NULL;
 	char **picture = NULL;
-	char **xpicture = NULL;
 	size_t max_height = 0;
 	size_t max_bytes = set_centers(linkage, center, word_offset,
 	                              print_word_0, N_words_to_print) +1;
@@ -567,100 +579,136 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 	unsigned int num_cols = center[N_words_to_print-1]+1;
 
 	if (max_bytes < num_cols) max_bytes = num_cols;
-	diagram_alloc_tmpmem(&start, &picture, &xpicture,
-	                     &max_height, HEIGHT_INC,
-	                     max_bytes, num_cols);
+	size_t row_size = max_bytes + 2;
+	diagram_alloc_tmpmem(&picmem, &picture, &max_height, HEIGHT_INC,
+	                     row_size, num_cols);
 
 	top_row = 0;
 
-	// Longer links are printed above the lower links.
-	for (link_length = 1; link_length < N_words_to_print; link_length++)
+	/* Longer links are printed above the lower links.
+	 * So order the links by their length (and then by their index),
+	 * using a counting sort. */
+	unsigned int *length_start = alloca((N_words_to_print+1) * sizeof(unsigned int));
+	LinkIdx *link_order = alloca((N_links+1) * sizeof(LinkIdx));
+	unsigned int N_links_to_print = 0;
+
+	memset(length_start, 0, (N_words_to_print+1) * sizeof(unsigned int));
+	for (j=0; j<N_links; j++)
 	{
-		for (j=0; j<N_links; j++)
+		link_length = diagram_link_length(linkage, j, print_word_0, print_word_N,
+		                                  N_words_to_print);
+		if (0 == link_length) continue;
+
+		length_start[link_length]++;
+		N_links_to_print++;
+	}
+	for (link_length = 1, i = 0; link_length < N_words_to_print; link_length++)
+	{
+		unsigned int n = length_start[link_length];
+		length_start[link_length] = i;
+		i += n;
+	}
+	for (j=0; j<N_links; j++)
+	{
+		link_length = diagram_link_length(linkage, j, print_word_0, print_word_N,
+		                                  N_words_to_print);
+		if (0 == link_length) continue;
+
+		link_order[length_start[link_length]++] = j;
+	}
+
+	for (unsigned int lnum = 0; lnum < N_links_to_print; lnum++)
+	{
+		j = link_order[lnum];
+
+		/* Put it into the lowest position */
+		/* Keep in mind that cl, cr are "columns" not "bytes" */
+		cl = center[ppla[j].lw];
+		cr = center[ppla[j].rw];
+		for (row=0; row < max_height; row++)
 		{
-			assert (ppla[j].lw != SIZE_MAX);
-			if (NULL == ppla[j].link_name) continue;
-			if (((unsigned int) (ppla[j].rw - ppla[j].lw)) != link_length)
-			  continue;
-			if (!print_word_0 && (ppla[j].lw == 0)) continue;
-			/* Gets rid of the irrelevant link to the left wall */
-			if (!print_word_N && (ppla[j].rw == linkage->num_words-1)) continue;
-
-			/* Put it into the lowest position */
-			/* Keep in mind that cl, cr are "columns" not "bytes" */
-			cl = center[ppla[j].lw];
-			cr = center[ppla[j].rw];
-			for (row=0; row < max_height; row++)
+			for (k=cl+1; k<cr; k++)
 			{
-				for (k=cl+1; k<cr; k++)
-				{
-					if (picture[row][k] != ' ') break;
-				}
-				if (k == cr) break;
+				if (picture[row][k] != ' ') break;
 			}
+			if (k == cr) break;
+		}
 
-			if (NULL != pctx) /* PS junk */
-			{
-				/* We know it fits, so put it in this row */
-				pctx->link_heights[j] = row;
-			}
+		if (NULL != pctx) /* PS junk */
+		{
+			/* We know it fits, so put it in this row */
+			pctx->link_heights[j] = row;
+		}
 
-			if (2*row+2 > max_height-1) {
-				lgdebug(+9, "Extending rows up to %d.\n", (2*row+2)+HEIGHT_INC);
-				diagram_alloc_tmpmem(&start, &picture, &xpicture,
-				                     &max_height, (2*row+2)+HEIGHT_INC,
-				                     max_bytes, num_cols);
-			}
-			if (row > top_row) top_row = row;
+		/* Keep an empty row above the links, so the next link fits. */
+		if (row+1 > max_height-1) {
+			lgdebug(+9, "Extending rows up to %d.\n", (row+1)+HEIGHT_INC);
+			diagram_alloc_tmpmem(&picmem, &picture, &max_height,
+			                     (row+1)+HEIGHT_INC, row_size, num_cols);
+		}
+		if (row > top_row) top_row = row;
 
-			picture[row][cl] = '+';
-			picture[row][cr] = '+';
-			for (k=cl+1; k<cr; k++) {
-				picture[row][k] = '-';
-			}
+		picture[row][cl] = '+';
+		picture[row][cr] = '+';
+		for (k=cl+1; k<cr; k++) {
+			picture[row][k] = '-';
+		}
 
-			s = ppla[j].link_name;
-			k = strlen(s);
-			inc = cl + cr + 2;
-			if (inc < k) inc = 0;
-			else inc = (inc-k)/2;
-			if (inc <= cl) {
-				t = picture[row] + cl + 1;
-			} else {
-				t = picture[row] + inc;
-			}
+		s = ppla[j].link_name;
+		k = strlen(s);
+		inc = cl + cr + 2;
+		if (inc < k) inc = 0;
+		else inc = (inc-k)/2;
+		if (inc <= cl) {
+			t = picture[row] + cl + 1;
+		} else {
+			t = picture[row] + inc;
+		}
 
-			/* Add direction indicator */
-			// if (DEPT_CHR == ppla[j]->lc->string[0]) { *(t-1) = '<'; }
-			if (DEPT_CHR == connector_string(ppla[j].lc)[0] &&
-			    (t > &picture[row][cl])) { picture[row][cl+1] = '<'; }
-			if (HEAD_CHR == connector_string(ppla[j].lc)[0]) { *(t-1) = '>'; }
+		/* Add direction indicator */
+		// if (DEPT_CHR == ppla[j]->lc->string[0]) { *(t-1) = '<'; }
+		if (DEPT_CHR == connector_string(ppla[j].lc)[0] &&
+		    (t > &picture[row][cl])) { picture[row][cl+1] = '<'; }
+		if (HEAD_CHR == connector_string(ppla[j].lc)[0]) { *(t-1) = '>'; }
 
-			/* Copy connector name; stop short if no room */
-			while ((*s != '\0') && (*t == '-')) *t++ = *s++;
+		/* Copy connector name; stop short if no room */
+		while ((*s != '\0') && (*t == '-')) *t++ = *s++;
 
-			/* Add direction indicator */
-			// if (DEPT_CHR == ppla[j]->rc->string[0]) { *t = '>'; }
-			if (DEPT_CHR == connector_string(ppla[j].rc)[0]) { picture[row][cr-1] = '>'; }
-			if (HEAD_CHR == connector_string(ppla[j].rc)[0]) { *t = '<'; }
+		/* Add direction indicator */
+		// if (DEPT_CHR == ppla[j]->rc->string[0]) { *t = '>'; }
+		if (DEPT_CHR == connector_string(ppla[j].rc)[0]) { picture[row][cr-1] = '>'; }
+		if (HEAD_CHR == connector_string(ppla[j].rc)[0]) { *t = '<'; }
 
-			/* The direction indicators may have clobbered these. */
-			picture[row][cl] = '+';
-			picture[row][cr] = '+';
+		/* The direction indicators may have clobbered these. */
+		picture[row][cl] = '+';
+		picture[row][cr] = '+';
 
-			/* Now put in the | below this one, where needed */
-			for (k=0; k<row; k++) {
-				if (picture[k][cl] == ' ') {
-					picture[k][cl] = '|';
-				}
-				if (picture[k][cr] == ' ') {
-					picture[k][cr] = '|';
-				}
+		/* Now put in the | below this one, where needed */
+		for (k=0; k<row; k++) {
+			if (picture[k][cl] == ' ') {
+				picture[k][cl] = '|';
+			}
+			if (picture[k][cr] == ' ') {
+				picture[k][cr] = '|';
 			}
 		}
 	}
 
+	/* If display_short is NOT true, then the linkage diagram is printed
+	 * in the "tall" style, with an extra row of vertical descenders
+	 * between each level. */
+	size_t num_xrows = display_short ? top_row + 3 : 2*top_row + 3;
+	size_t num_descender_rows = display_short ? 1 : top_row + 1;
+
+	/* The rows to be printed (bottom up): The words, and the link
+	 * picture rows interleaved with rows of descenders. The picture rows
+	 * are used in place; only the words and the descenders need memory. */
+	char **xpicture = malloc(num_xrows * sizeof(char *));
+	char *xmem = malloc((1 + num_descender_rows) * row_size);
+	size_t *start = malloc(num_xrows * sizeof(size_t));
+
 	/* We have the link picture, now put in the words and extra "|"s */
+	xpicture[0] = xmem;
 	t = xpicture[0];
 	if (print_word_0) k = 0; else k = 1;
 	for (; k<N_words_to_print; k++)
@@ -675,10 +723,8 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 	}
 	*t = '\0';
 
-	/* If display_short is NOT true, then the linkage diagram is printed
-	 * in the "tall" style, with an extra row of vertical descenders
-	 * between each level. */
 	if (display_short) {
+		xpicture[1] = xmem + row_size;
 		for (k=0; picture[0][k] != '\0'; k++) {
 			if ((picture[0][k] == '+') || (picture[0][k] == '|')) {
 				xpicture[1][k] = '|';
@@ -688,12 +734,13 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 		}
 		xpicture[1][k] = '\0';
 		for (row=0; row < top_row+1; row++) {
-			strcpy(xpicture[row+2], picture[row]);
+			xpicture[row+2] = picture[row];
 		}
 		top_row += 2;
 	} else {
 		for (row=0; row < top_row+1; row++) {
-			strcpy(xpicture[2*row+2],picture[row]);
+			xpicture[2*row+2] = picture[row];
+			xpicture[2*row+1] = xmem + (row+1) * row_size;
 			for (k=0; picture[row][k] != '\0'; k++) {
 				if ((picture[row][k] == '+') || (picture[row][k] == '|')) {
 					xpicture[2*row+1][k] = '|';
@@ -706,7 +753,11 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 		top_row = 2*top_row + 2;
 	}
 
-	/* We've built the picture, now print it out. */
+	/* We've built the picture, now print it out.
+	 * Reserve room for all of its rows, and for the row separators of
+	 * each screen-width part. */
+	size_t num_parts = num_cols / (x_screen_width - RIGHT_MARGIN) + 1;
+	dyn_str_reserve(string, (top_row + 1) * (row_size + num_parts) + num_parts);
 
 	/* Start locations, for each row.  These may vary, due to different
 	 * column-widths of utf8 glyphs. */
@@ -723,7 +774,6 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 
 	if (print_word_0) i = 0; else i = 1;
 	unsigned int c = 0; /* Character offset in the last word on a row. */
-#define RIGHT_MARGIN 1
 	while (i < N_words_to_print)
 	{
 		unsigned int revrs;
@@ -774,6 +824,21 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 			k = start[row];
 			for (j = k; (glyph_width < uwidth) && (xpicture[row][j] != '\0'); )
 			{
+				// Fast path: Copy a run of printable ASCII characters,
+				// which are one column wide each, at once.
+				const char *p = &xpicture[row][j];
+				size_t n;
+				for (n = 0; (glyph_width + n < uwidth) &&
+				            (' ' <= p[n]) && (p[n] < 0x7f); n++)
+					;
+				if (0 < n)
+				{
+					dyn_strncat(string, p, n);
+					glyph_width += n;
+					j += n;
+					continue;
+				}
+
 				// If we don't have a glyph for this code-point,
 				// then assume the terminal will use a two-column-
 				// -wide "box font" with the hex code inside.
@@ -796,7 +861,11 @@ linkage_print_diagram_ctxt(const Linkage linkage,
 		dyn_strcat(string, "\n");
 	}
 
-	diagram_free_tmpmem(start, picture, xpicture, max_height);
+	free(start);
+	free(xmem);
+	free(xpicture);
+	free(picture);
+	free(picmem);
 	return dyn_str_take(string);
 }
 
@@ -1,7 +0,0 @@
-#ifndef __FAST_SPRINTF_HPP__
-#define __FAST_SPRINTF_HPP__
-
-char* fast_sprintf(char* buffer, int num);
-char* fast_sprintf(char* buffer, const char* str);
-
-#endif
@@ -41,12 +41,19 @@ public:
   /* Abstract functions that calculate params for each type of variable */
 
   /* string variables */
-  virtual void setStringParameters  (int var, const char* str)
+  virtual void setStringParameters  (int var)
   {
     bool isDecision = false;
     setParameters(var, isDecision, 0.0, 0.0);
   }
-  virtual void setStringParameters  (int var, const char* str, double cost) = 0;
+  virtual void setStringParameters  (int var, double cost) = 0;
+
+  /* word variables (of the non-optional words, which may be null words) */
+  virtual void setWordParameters    (int var)
+  {
+    bool isDecision = true;
+    setParameters(var, isDecision, 0.0, 0.0);
+  }
 
   /* epsilon variables */
   virtual void setEpsilonParameters (int var)
@@ -151,7 +158,7 @@ public:
     : Guiding(sent) {
   }
 
-  virtual void setStringParameters(int var, const char* str, double cost)
+  virtual void setStringParameters(int var, double cost)
   {
     bool isDecision = cost > 0.0;
     double priority = cost2priority(cost);
@@ -216,7 +223,7 @@ public:
     : Guiding(sent) {
   }
 
-  virtual void setStringParameters  (int var, const char* str, double cost)
+  virtual void setStringParameters  (int var, double cost)
   {
     bool isDecision = cost > 0.0;
     double priority = cost2priority(cost);
@@ -27,7 +27,6 @@ extern "C" {
 #include "word-tag.hpp"
 #include "matrix-ut.hpp"
 #include "clock.hpp"
-#include "fast-sprintf.hpp"
 
 extern "C" {
 #include "dict-common/dict-api.h"    // for print_expression()
@@ -40,8 +39,10 @@ extern "C" {
 #include "prepare/build-disjuncts.h" // for build_disjuncts_for_exp()
 #include "post-process/post-process.h"
 #include "post-process/pp-structures.h"
+#include "resources.h"                // for resources_exhausted()
 #include "tokenize/word-structures.h" // for Word_struct
 #include "tokenize/tok-structures.h"  // got Gword internals
+#include "tokenize/wordgraph.h"      // for in_same_alternative()
 }
 
 // Macro DEBUG_print is used to dump to stdout information while debugging
@@ -53,6 +54,10 @@ extern "C" {
 
 #define D_SAT 5
 
+// The number of conflicts after which the solver checks if the parse
+// resources are exhausted.
+#define SOLVE_CONFLICT_BUDGET 2000
+
 // Convert a NULL C string pointer, for printing a possibly NULL string
 #define N(s) ((s) ? (s) : "(null)")
 
@@ -222,6 +227,13 @@ void SATEncoder::encode() {
     DEBUG_print(clock.elapsed());
 #endif
 
+    if (_eager_constraints) {
+      if (!test_enabled("linkage-disconnected"))
+        generate_span_connectivity();
+      generate_alternatives_consistency();
+      DEBUG_print(clock.elapsed());
+    }
+
     generate_encoding_specific_clauses();
     DEBUG_print(clock.elapsed());
 
@@ -229,23 +241,135 @@ void SATEncoder::encode() {
     power_prune();
     DEBUG_print(clock.elapsed());
 
+    add_variable(_variables->size() - 1);
     _variables->setVariableParameters(_solver);
+
+    lgdebug(+D_SAT, "Encoded %d variables, %d clauses in %.3f sec\n",
+            _solver->nVars(), _solver->nClauses(), clock.elapsed());
 }
 
 
 
+bool SATEncoder::reusable(Parse_Options opts) const
+{
+  // The expressions are pruned again on each parse, which doesn't change
+  // them if the connector length limits are the same.
+  if ((opts->short_length != _short_length) ||
+      (opts->all_short != _all_short) ||
+      (opts->perform_pp_prune != _perform_pp_prune) ||
+      (opts->sat_eager_constraints != _eager_constraints) ||
+      (parse_options_get_disjunct_cost(opts) < _cost_cutoff))
+    return false;
+
+  for (size_t w = 0; w < _sent->length; w++)
+    if (_sent->word[w].x != _word_xnodes[w]) return false;
+
+  return true;
+}
+
+void SATEncoder::set_parse_options(Parse_Options opts)
+{
+  _opts = opts;
+  verbosity = opts->verbosity;
+  debug = opts->debug;
+  test = opts->test;
+}
+
+/**
+ * Prepare the solver for a new enumeration of the linkages, that have
+ * exactly null_count null words and whose disjunct costs don't exceed
+ * the current cost cutoff. All of that is done by assumptions, so the
+ * clauses that the solver has learned so far remain valid.
+ */
+void SATEncoder::start_round(size_t null_count)
+{
+  _assumptions.clear();
+
+  if (null_count > 0)
+    _assumptions.push(null_count_at_least(null_count));
+  _assumptions.push(~null_count_at_least(null_count + 1));
+
+  double cost_cutoff = parse_options_get_disjunct_cost(_opts);
+  for (const auto& guard: _cost_guards)
+    _assumptions.push((guard.first > cost_cutoff) ? ~Lit(guard.second) : Lit(guard.second));
+
+  // Discard the clauses that prohibit the linkages of the previous round.
+  if (_round_var != -1)
+    generate_literal(~Lit(_round_var));
+  _round_var = _variables->auxiliary();
+  _assumptions.push(Lit(_round_var));
+
+  add_variable(_variables->size() - 1);
+  _variables->setVariableParameters(_solver);
+}
+
+Lit SATEncoder::false_literal()
+{
+  if (_false_var == -1) {
+    _false_var = _variables->auxiliary();
+    generate_literal(~Lit(_false_var));
+  }
+  return Lit(_false_var);
+}
+
+/**
+ * The null word counter is a sequential counter over the nullable
+ * words: _null_counter[k-1][i] is true iff at least k of the first i+1
+ * of them are null words. Its column k is generated when it is first
+ * needed.
+ */
+Lit SATEncoder::null_count_at_least(size_t k)
+{
+  size_t m = _nullable_words.size();
+  if (k == 0) return ~false_literal();
+  if (k > m) return false_literal();
+
+  while (_null_counter.size() < k) {
+    size_t j = _null_counter.size() + 1; // The column to generate
+    _null_counter.push_back(std::vector<Lit>());
+    std::vector<Lit>& column = _null_counter.back();
+
+    for (size_t i = 0; i < m; i++) {
+      Lit null_word = ~Lit(_nullable_words[i]);
+
+      if (i + 1 < j) {
+        column.push_back(false_literal());
+        continue;
+      }
+
+      Lit carry = null_word;
+      if (j > 1) {
+        vec<Lit> rhs;
+        rhs.push(null_word);
+        rhs.push(_null_counter[j-2][i-1]);
+        carry = Lit(_variables->auxiliary());
+        generate_classical_and_definition(carry, rhs);
+      }
+
+      if (i + 1 == j) {
+        column.push_back(carry);
+      } else {
+        vec<Lit> rhs;
+        rhs.push(column[i-1]);
+        rhs.push(carry);
+        Lit at_least = Lit(_variables->auxiliary());
+        generate_or_definition(at_least, rhs);
+        column.push_back(at_least);
+      }
+    }
+  }
+
+  return _null_counter[k-1][m-1];
+}
+
 /*-------------------------------------------------------------------------*
  *                         W O R D - T A G S                               *
  *-------------------------------------------------------------------------*/
 void SATEncoder::build_word_tags()
 {
-  char name[MAX_VARIABLE_NAME];
-  name[0] = 'w';
-
   for (size_t w = 0; w < _sent->length; w++) {
-    // sprintf(name, "w%zu", w);
-    fast_sprintf(name+1, w);
-    _word_tags.push_back(WordTag(w, name, _variables, _sent, _opts));
+    _word_tags.push_back(WordTag(w, _variables, _sent, _opts));
+    _word_xnodes.push_back(_sent->word[w].x);
     int dfs_position = 0;
 
     if (_sent->word[w].x == NULL) continue;
@@ -265,7 +389,7 @@ void SATEncoder::build_word_tags()
     std::vector<int> eps_right, eps_left;
 
     _word_tags[w].insert_connectors(exp, dfs_position, leading_right,
-         leading_left, eps_right, eps_left, name, true, 0, NULL, _sent->word[w].x);
+         leading_left, eps_right, eps_left, w, true, 0, NULL, _sent->word[w].x);
 
     if (join)
       free_alternatives(exp);
@@ -309,8 +433,6 @@ bool SATEncoder::matches_in_interval(int wi, int pi, int l, int r) {
 
 void SATEncoder::generate_satisfaction_conditions()
 {
-  char name[MAX_VARIABLE_NAME] = "w";
-
   for (size_t w = 0; w < _sent->length; w++) {
 
 #ifdef SAT_DEBUG
@@ -321,12 +443,10 @@ void SATEncoder::generate_satisfaction_conditions()
     cout << endl;
 #endif
 
-    fast_sprintf(name+1, w);
-
     if (_sent->word[w].optional)
-      _variables->string(name);
+      _variables->string(w);
     else
-      determine_satisfaction(w, name);
+      determine_satisfaction(w, w);
 
     if (_sent->word[w].x == NULL) {
       if (!_sent->word[w].optional) {
@@ -341,16 +461,34 @@ void SATEncoder::generate_satisfaction_conditions()
     Exp* exp = join ? join_alternatives(w) : _sent->word[w].x->exp;
 
     int dfs_position = 0;
-    generate_satisfaction_for_expression(w, dfs_position, exp, name, 0);
+    generate_satisfaction_for_expression(w, dfs_position, exp, w, 0);
 
     if (join)
       free_alternatives(exp);
   }
+
+  for (size_t w = 0; w < _sent->length; w++) {
+    if (_sent->word[w].optional) continue;
+    _variables->word(w);
+    _nullable_words.push_back(w);
+  }
+}
+
+void SATEncoder::generate_cost_cutoff(Lit lhs, double total_cost)
+{
+  auto guard = _cost_guards.find(total_cost);
+  if (guard == _cost_guards.end())
+    guard = _cost_guards.insert(std::make_pair(total_cost, _variables->auxiliary())).first;
+
+  vec<Lit> clause(2);
+  clause[0] = ~lhs;
+  clause[1] = Lit(guard->second);
+  add_clause(clause);
 }
 
 
 void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position, Exp* e,
-                                                      char* var, double parent_cost)
+                                                      int var, double parent_cost)
 {
   E_list *l;
   double total_cost = parent_cost + e->cost;
@@ -362,7 +500,7 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
 
     if (total_cost > _cost_cutoff) {
       Lit lhs = Lit(_variables->string_cost(var, e->cost));
-      generate_literal(~lhs);
+      generate_cost_cutoff(lhs, total_cost);
     }
   } else {
     if (e->type == AND_type) {
@@ -370,7 +508,7 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
         /* zeroary and */
         _variables->string_cost(var, e->cost);
         if (total_cost > _cost_cutoff) {
-          generate_literal(~Lit(_variables->string_cost(var, e->cost)));
+          generate_cost_cutoff(Lit(_variables->string_cost(var, e->cost)), total_cost);
         }
       } else if (e->u.l != NULL && e->u.l->next == NULL) {
         /* unary and - skip */
@@ -378,22 +516,11 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
       } else {
         /* n-ary and */
         int i;
-
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
+        int child = _variables->exp_node_children(var, e);
 
         vec<Lit> rhs;
         for (i = 0, l=e->u.l; l!=NULL; l=l->next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-          rhs.push(Lit(_variables->string(new_var)));
+          rhs.push(Lit(_variables->string(child + i)));
         }
 
         Lit lhs = Lit(_variables->string_cost(var, e->cost));
@@ -407,12 +534,7 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
 
         /* Recurse */
         for (i = 0, l=e->u.l; l!=NULL; l=l->next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-
-          generate_satisfaction_for_expression(w, dfs_position, l->e, new_var, total_cost);
+          generate_satisfaction_for_expression(w, dfs_position, l->e, child + i, total_cost);
         }
       }
     } else if (e->type == OR_type) {
@@ -426,22 +548,11 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
       } else {
         /* n-ary or */
         int i;
-
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while ((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
+        int child = _variables->exp_node_children(var, e);
 
         vec<Lit> rhs;
         for (i = 0, l=e->u.l; l!=NULL; l=l->next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'd';
-          fast_sprintf(s, i);
-          rhs.push(Lit(_variables->string(new_var)));
+          rhs.push(Lit(_variables->string(child + i)));
         }
 
         Lit lhs = Lit(_variables->string_cost(var, e->cost));
@@ -450,11 +561,7 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
 
         /* Recurse */
         for (i = 0, l=e->u.l; l!=NULL; l=l->next, i++) {
-          char* s = last_new_var;
-          *s++ = 'd';
-          fast_sprintf(s, i);
-
-          generate_satisfaction_for_expression(w, dfs_position, l->e, new_var, total_cost);
+          generate_satisfaction_for_expression(w, dfs_position, l->e, child + i, total_cost);
         }
       }
     }
@@ -900,10 +1007,10 @@ static void debug_generate_disconnectivity_prohibiting(vector<int> components,
   * For example, a linkage with 7 words, which consists of 3 segments
   * (islands) of 2,2,3 words, will be represented as: 0 0 1 1 2 2 2.
   *
-  * In order to support optional words (words that are allowed to have
-  * no connectivity), optional words which don't participate in the linkage
-  * are marked with -1 instead of their segment number, and are disregarded
-  * in the connectivity test.
+  * In order to support optional words and null words (words that are
+  * allowed to have no connectivity), words which don't participate in the
+  * linkage are marked with -1 instead of their segment number, and are
+  * disregarded in the connectivity test.
   */
 bool SATEncoder::connectivity_components(std::vector<int>& components) {
   // get satisfied linked(wi, wj) variables
@@ -917,7 +1024,7 @@ bool SATEncoder::connectivity_components(std::vector<int>& components) {
   }
 
   // Words that are not in the linkage don't need to be connected.
-  // (For now these can be only be words marked as "optional").
+  // (These are the missing optional words and the null words).
   std::vector<bool> is_linked_word(_sent->length, false);
   for (size_t node = 0; node < _sent->length; node++) {
     is_linked_word[node] = _solver->model[node] == l_True;
@@ -944,13 +1051,15 @@ bool SATEncoder::connectivity_components(std::vector<int>& components) {
 
   CONNECTIVITY_DEBUG(printf("connectivity_components: "));
   bool connected = true;
+  int first_component = -1;
   for (size_t node = 0; node < _sent->length; node++) {
     CONNECTIVITY_DEBUG(
       if (is_linked_word[node]) printf("%d ", components[node]);
       else                      printf("[%d] ", components[node]);
     )
     if (is_linked_word[node]) {
-      if (components[node] != 0) {
+      if (first_component == -1) first_component = components[node];
+      if (components[node] != first_component) {
         connected = false;
       }
     } else {
@@ -1033,11 +1142,10 @@ void SATEncoder::generate_disconnectivity_prohibiting(std::vector<int> component
           bool conditional_link_var_exists;
 
           CONNECTIVITY_DEBUG(printf("R ")); // "replaced"
-          char name[MAX_VARIABLE_NAME] = "0";
-          sprintf(name+1, "%dw%dw%d", var, optlw_exists?lv->left_word:255,
-                                           optrw_exists?lv->right_word:255);
-          conditional_link_var_exists = _variables->var_exists(name);
-          conditional_link_var = _variables->string(name);
+          conditional_link_var_exists =
+            _variables->conditional_link(var, optlw_exists?lv->left_word:255,
+                                              optrw_exists?lv->right_word:255,
+                                              conditional_link_var);
 
           if (!conditional_link_var_exists) {
             Lit lhs = Lit(conditional_link_var);
@@ -1054,15 +1162,26 @@ void SATEncoder::generate_disconnectivity_prohibiting(std::vector<int> component
       }
     }
 
-    if (missing_word) {
-      // The connectivity may be restored differently if a word reappears
-      for (WordIdx w = 0; w < _sent->length; w++) {
-        if (_solver->model[w] == l_False)
+    // The connectivity may be restored differently if a missing optional
+    // word reappears. Also, the component doesn't need a link to the
+    // other words if one of its words becomes a null word, or if all the
+    // other words become null words (it suffices to mention one of them).
+    bool other_word_found = false;
+    for (WordIdx w = 0; w < _sent->length; w++) {
+      if (_solver->model[w] == l_False) {
+        if (missing_word && _sent->word[w].optional)
           clause.push(Lit(w));
+      } else if (!_sent->word[w].optional) {
+        if (components[w] == *c) {
+          clause.push(~Lit(w));
+        } else if (!other_word_found) {
+          clause.push(~Lit(w));
+          other_word_found = true;
+        }
       }
     }
     CONNECTIVITY_DEBUG(printf("\n"));
-    _solver->addClause(clause);
+    add_clause(clause);
 
     // Avoid issuing two identical clauses
     if (different_components.size() == 2)
@@ -1070,6 +1189,179 @@ void SATEncoder::generate_disconnectivity_prohibiting(std::vector<int> component
   }
 }
 
+/**
+ * Generate clauses that enforce the connectivity in advance.
+ *
+ * The components of a disconnected planar linkage cannot cross each
+ * other, so the one with the smallest span among those that don't
+ * contain the first word is a span of consecutive words (with possibly
+ * some missing optional words in it). Hence requiring each span of words
+ * [a, b] (a > 0) to be linked to a word outside of it prohibits all the
+ * disconnected linkages, except some of those that have missing optional
+ * words. Connectivity is still checked after solving, as before.
+ *
+ * To keep the clauses short, linked_beyond(w, b, dir) variables are
+ * defined recursively, for the words that can be linked beyond b.
+ */
+void SATEncoder::generate_span_connectivity()
+{
+  int n = _sent->length;
+
+  // The variables that tell if w is linked after b (right) or before a
+  // (left), or -1 if it cannot be.
+  Matrix<int> right(n, -1), left(n, -1);
+
+  for (int w = 0; w < n; w++) {
+    for (int b = n - 2; b >= w; b--) {
+      vec<Lit> rhs;
+      if (_linked_possible(w, b + 1))
+        rhs.push(Lit(_variables->linked(w, b + 1)));
+      if (right(w, b + 1) != -1)
+        rhs.push(Lit(right(w, b + 1)));
+
+      if (rhs.size() == 1) {
+        right.set(w, b, var(rhs[0]));
+      } else if (rhs.size() > 1) {
+        int v = _variables->linked_beyond(w, b, '+');
+        generate_or_definition(Lit(v), rhs);
+        right.set(w, b, v);
+      }
+    }
+
+    for (int a = 1; a <= w; a++) {
+      vec<Lit> rhs;
+      if (_linked_possible(a - 1, w))
+        rhs.push(Lit(_variables->linked(a - 1, w)));
+      if (left(w, a - 1) != -1)
+        rhs.push(Lit(left(w, a - 1)));
+
+      if (rhs.size() == 1) {
+        left.set(w, a, var(rhs[0]));
+      } else if (rhs.size() > 1) {
+        int v = _variables->linked_beyond(w, a, '-');
+        generate_or_definition(Lit(v), rhs);
+        left.set(w, a, v);
+      }
+    }
+  }
+
+  // The clauses don't apply to linkages with null words.
+  Lit has_null_words = null_count_at_least(1);
+
+  vec<Lit> clause;
+  for (int a = 1; a < n; a++) {
+    for (int b = a; b < n; b++) {
+      clause.clear();
+      clause.push(has_null_words);
+      for (int w = a; w <= b; w++) {
+        if (right(w, b) != -1) clause.push(Lit(right(w, b)));
+        if (left(w, a) != -1) clause.push(Lit(left(w, a)));
+        if (_sent->word[w].optional) clause.push(~Lit(w));
+      }
+      add_clause(clause);
+    }
+  }
+}
+
+/**
+ * Generate clauses that prohibit mixing tokenization alternatives.
+ *
+ * For each word, find the distinct wordgraph words from which its X_nodes
+ * originate. If there are several, a word_alternative(w, i) variable is
+ * defined for each of them, as the disjunction of the variables of the
+ * corresponding alternatives of the joined word expression (see
+ * join_alternatives()). Then each two such wordgraph words, of different
+ * sentence words, that are not in the same alternative, are mutually
+ * excluded. This is what sane_linkage_morphism() mostly rejects.
+ */
+void SATEncoder::generate_alternatives_consistency()
+{
+  vector<vector<std::pair<Gword *, Lit>>> alternatives(_sent->length);
+
+  for (size_t w = 0; w < _sent->length; w++) {
+    const X_node *x = _sent->word[w].x;
+    if (x == NULL) continue;
+
+    vector<Gword *> gwords;
+    for (; x != NULL; x = x->next) {
+      Gword *gw = (Gword *)x->word;
+      if (std::find(gwords.begin(), gwords.end(), gw) == gwords.end())
+        gwords.push_back(gw);
+    }
+
+    if (gwords.size() == 1) {
+      alternatives[w].push_back(std::make_pair(gwords[0], Lit(w)));
+      continue;
+    }
+
+    // Here the word has more than one X_node, and each of them is a
+    // child of the root node.
+    Exp* exp = join_alternatives(w);
+    int child = _variables->exp_node_children(w, exp);
+    free_alternatives(exp);
+
+    for (size_t i = 0; i < gwords.size(); i++) {
+      vec<Lit> rhs;
+      int c = 0;
+      for (x = _sent->word[w].x; x != NULL; x = x->next, c++) {
+        if (x->word == gwords[i])
+          rhs.push(Lit(_variables->string(child + c)));
+      }
+      Lit lhs = Lit(_variables->word_alternative(w, i));
+      generate_or_definition(lhs, rhs);
+      alternatives[w].push_back(std::make_pair(gwords[i], lhs));
+    }
+  }
+
+  vec<Lit> clause(2);
+  for (size_t wi = 0; wi < _sent->length; wi++) {
+    for (size_t wj = wi + 1; wj < _sent->length; wj++) {
+      for (const auto& ai: alternatives[wi]) {
+        for (const auto& aj: alternatives[wj]) {
+          if (in_same_alternative(ai.first, aj.first)) continue;
+          clause[0] = ~ai.second;
+          clause[1] = ~aj.second;
+          add_clause(clause);
+        }
+      }
+    }
+  }
+
+  // A word that results from a split requires the other words of its
+  // alternative, which may be optional words. If such a word got split
+  // further, the word at its position may also be the first word of one
+  // of its own alternatives. (A null word may stand for any word, so
+  // these clauses don't apply to linkages with null words.)
+  Lit has_null_words = null_count_at_least(1);
+  for (size_t wi = 0; wi < _sent->length; wi++) {
+    for (const auto& ai: alternatives[wi]) {
+      const Gword **hpi = wordgraph_hier_position(ai.first);
+      size_t depth = ai.first->hier_depth;
+      if (depth == 0) continue; // An original sentence word
+
+      for (size_t wj = 0; wj < _sent->length; wj++) {
+        if (wj == wi) continue;
+
+        bool sibling_found = false;
+        clause.clear();
+        clause.push(has_null_words);
+        clause.push(~ai.second);
+        for (const auto& aj: alternatives[wj]) {
+          const Gword **hpj = wordgraph_hier_position(aj.first);
+          size_t i;
+          for (i = 0; i < 2 * depth; i++)
+            if (hpj[i] != hpi[i]) break;
+          if (i < 2 * depth) continue;
+
+          clause.push(aj.second);
+          if (aj.first->hier_depth == depth) sibling_found = true;
+        }
+        if (sibling_found) add_clause(clause);
+      }
+    }
+  }
+}
+
 /*--------------------------------------------------------------------------*
  *                           P L A N A R I T Y                              *
  *--------------------------------------------------------------------------*/
@@ -1109,18 +1401,13 @@ void SATEncoder::generate_epsilon_definitions()
     bool join = _sent->word[w].x->next != NULL;
     Exp* exp = join ? join_alternatives(w) : _sent->word[w].x->exp;
 
-    char name[MAX_VARIABLE_NAME];
-    // sprintf(name, "w%zu", w);
-    name[0] = 'w';
-    fast_sprintf(name+1, w);
-
     int dfs_position;
 
     dfs_position = 0;
-    generate_epsilon_for_expression(w, dfs_position, exp, name, true, '+');
+    generate_epsilon_for_expression(w, dfs_position, exp, w, true, '+');
 
     dfs_position = 0;
-    generate_epsilon_for_expression(w, dfs_position, exp, name, true, '-');
+    generate_epsilon_for_expression(w, dfs_position, exp, w, true, '-');
 
     if (join)
       free_alternatives(exp);
@@ -1128,19 +1415,17 @@ void SATEncoder::generate_epsilon_definitions()
 }
 
 bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp* e,
-                                                 char* var, bool root, char dir)
+                                                 int var, bool root, char dir)
 {
   if (e->type == CONNECTOR_type) {
     dfs_position++;
-    if (var != NULL) {
-      if (e->dir == dir) {
-        // generate_literal(-_variables->epsilon(name, var, e->dir));
-        return false;
-      } else {
-        generate_equivalence_definition(Lit(_variables->epsilon(var, dir)),
-                                        Lit(_variables->string(var)));
-        return true;
-      }
+    if (e->dir == dir) {
+      // generate_literal(-_variables->epsilon(name, var, e->dir));
+      return false;
+    } else {
+      generate_equivalence_definition(Lit(_variables->epsilon(var, dir)),
+                                      Lit(_variables->string(var)));
+      return true;
     }
   } else if (e->type == AND_type) {
     if (e->u.l == NULL) {
@@ -1157,23 +1442,10 @@ bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp*
         E_list* l;
         int i;
         bool eps = true;
-
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while ((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
-
+        int child = _variables->exp_node_children(var, e);
 
         for (i = 0, l = e->u.l; l != NULL; l = l->next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-
-          if (!generate_epsilon_for_expression(w, dfs_position, l->e, new_var, false, dir)) {
+          if (!generate_epsilon_for_expression(w, dfs_position, l->e, child + i, false, dir)) {
             eps = false;
             break;
           }
@@ -1188,11 +1460,7 @@ bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp*
           Lit lhs = Lit(_variables->epsilon(var, dir));
           vec<Lit> rhs;
           for (i = 0, l=e->u.l; l!=NULL; l=l->next, i++) {
-            // sprintf(new_var, "%sc%d", var, i)
-            char* s = last_new_var;
-            *s++ = 'c';
-            fast_sprintf(s, i);
-            rhs.push(Lit(_variables->epsilon(new_var, dir)));
+            rhs.push(Lit(_variables->epsilon(child + i, dir)));
           }
           generate_classical_and_definition(lhs, rhs);
         }
@@ -1207,24 +1475,12 @@ bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp*
       E_list* l;
       int i;
       bool eps = false;
-
-      char new_var[MAX_VARIABLE_NAME];
-      char* last_new_var = new_var;
-      char* last_var = var;
-      while ((*last_new_var = *last_var)) {
-        last_new_var++;
-        last_var++;
-      }
+      int child = _variables->exp_node_children(var, e);
 
       vec<Lit> rhs;
       for (i = 0, l = e->u.l; l != NULL; l = l->next, i++) {
-        // sprintf(new_var, "%sc%d", var, i)
-        char* s = last_new_var;
-        *s++ = 'd';
-        fast_sprintf(s, i);
-
-        if (generate_epsilon_for_expression(w, dfs_position, l->e, new_var, false, dir) && !root) {
-          rhs.push(Lit(_variables->epsilon(new_var, dir)));
+        if (generate_epsilon_for_expression(w, dfs_position, l->e, child + i, false, dir) && !root) {
+          rhs.push(Lit(_variables->epsilon(child + i, dir)));
           eps = true;
         }
       }
@@ -1429,7 +1685,7 @@ Linkage SATEncoder::create_linkage()
 
   partial_init_linkage(_sent, linkage, _sent->length);
   sat_extract_links(linkage);
-  compute_link_names(linkage, _sent->string_set);
+  compute_link_names(linkage);
   return linkage;
 }
 
@@ -1445,7 +1701,28 @@ void SATEncoder::generate_linkage_prohibiting()
       clause.push(Lit(var));
     }
   }
-  _solver->addClause(clause);
+  clause.push(~Lit(_round_var));
+  add_clause(clause);
+}
+
+/**
+ * Solve under the assumptions of the current round. The solver runs
+ * with a conflict budget, in order to check between the runs if the
+ * resources of the parse got exhausted (then false is returned, as if
+ * there is no solution).
+ */
+bool SATEncoder::solve()
+{
+  lbool result;
+
+  _num_solves++;
+  do {
+    if (resources_exhausted(_opts->resources)) return false;
+    _solver->setConfBudget(SOLVE_CONFLICT_BUDGET);
+    result = _solver->solveLimited(_assumptions);
+  } while (result == l_Undef);
+
+  return result == l_True;
 }
 
 Linkage SATEncoder::get_next_linkage()
@@ -1460,13 +1737,14 @@ Linkage SATEncoder::get_next_linkage()
    * Disconnected linkages are normally ignored, unless
    * !test=linkage-disconnected is used (and they are sane) */
   do {
-    if (!_solver->solve()) return NULL;
+    if (!solve()) return NULL;
 
     std::vector<int> components;
     connected = connectivity_components(components);
 
     // Prohibit this solution so the next ones can be found
     if (!connected) {
+      _num_disconnected++;
       generate_disconnectivity_prohibiting(components);
       display_linkage_disconnected = test_enabled("linkage-disconnected");
     } else {
@@ -1477,6 +1755,7 @@ Linkage SATEncoder::get_next_linkage()
       linkage = create_linkage();
       sane = sane_linkage_morphism(_sent, linkage, _opts);
       if (!sane) {
+          _num_insane++;
           free_linkage_connectors_and_disjuncts(linkage);
           free_linkage(linkage);
           free(linkage);
@@ -1548,19 +1827,19 @@ void SATEncoderConjunctionFreeSentences::generate_encoding_specific_clauses() {
 }
 
 void SATEncoderConjunctionFreeSentences::handle_null_expression(int w) {
-  // Formula is unsatisfiable
-  vec<Lit> clause;
-  add_clause(clause);
+  // The word can only be a null word
+  generate_literal(~Lit(w));
 }
 
-void SATEncoderConjunctionFreeSentences::determine_satisfaction(int w, char* name)
+void SATEncoderConjunctionFreeSentences::determine_satisfaction(int w, int var)
 {
-  // All tags must be satisfied
-  generate_literal(Lit(_variables->string(name)));
+  // All tags must be satisfied, except those of null words. The number
+  // of null words is set by assumptions (see start_round()).
+  _variables->string(var);
 }
 
 void SATEncoderConjunctionFreeSentences::generate_satisfaction_for_connector(
-    int wi, int pi, Exp *e, char* var)
+    int wi, int pi, Exp *e, int var)
 {
   const char* Ci = e->u.condesc->string;
   char dir = e->dir;
@@ -1824,10 +2103,10 @@ bool SATEncoderConjunctionFreeSentences::sat_extract_links(Linkage lkg)
   for (WordIdx wi = 0; wi < _sent->length; wi++) {
     Exp *de = exp_word[wi];
 
-    // Skip optional words
+    // Skip optional words and null words
     if (xnode_word[wi] == NULL)
     {
-      if (!_sent->word[wi].optional)
+      if (!_sent->word[wi].optional && (_solver->model[wi] == l_True))
         prt_error("Warning: Non-optional word %zu has no linkage\n", wi);
       continue;
     }
@@ -1854,39 +2133,42 @@ bool SATEncoderConjunctionFreeSentences::sat_extract_links(Linkage lkg)
 
 /**
  * Main entry point into the SAT parser.
+ * The formula is kept with the sentence, and its solver is used
+ * incrementally: the null count and the cost cutoff are set by
+ * assumptions, so parsing with more null words, or parsing the sentence
+ * again (e.g. with !null=1 after no complete linkage has been found),
+ * reuses what the solver has learned.
  * A note about panic mode:
  * - The MiniSAT support for timeout is not yet used (FIXME).
- * - Parsing with null links is not supported (FIXME).
  * So nothing particularly useful happens in a panic mode, and it is
  * left for the user to disable it.
  */
 extern "C" int sat_parse(Sentence sent, Parse_Options  opts)
 {
-  if (opts->min_null_count > 0) {
-    // The sat solver doesn't support (yet) parsing with nulls.
-    // For now, just avoid the delay of a useless re-parsing.
-    if (opts->verbosity >= 1)
-      prt_error("Info: use-sat: Cannot parse with null links (yet).\n"
-                "              Set the \"null\" option to 0 to turn off "
-                "parsing with null links.\n");
-    sent->num_valid_linkages = 0;
-    sent->num_linkages_post_processed = 0;
-    return 0;
-  }
-
   SATEncoder* encoder = (SATEncoder*) sent->hook;
   if (encoder) {
     sat_free_linkages(sent, encoder->_next_linkage_index);
-    delete encoder;
+    encoder->_next_linkage_index = 0;
+    if (!encoder->reusable(opts)) {
+      delete encoder;
+      encoder = NULL;
+    }
   }
 
-  encoder = new SATEncoderConjunctionFreeSentences(sent, opts);
-  sent->hook = encoder;
-  encoder->encode();
+  if (encoder) {
+    encoder->set_parse_options(opts);
+    lgdebug(+D_SAT, "Reusing the formula of the previous parse\n");
+  } else {
+    encoder = new SATEncoderConjunctionFreeSentences(sent, opts);
+    sent->hook = encoder;
+    encoder->encode();
+  }
 
   LinkageIdx linkage_limit = opts->linkage_limit;
-  LinkageIdx k;
+  LinkageIdx k = 0;
   Linkage lkg = NULL;
+  size_t max_null_count = MIN((size_t)opts->max_null_count,
+                              encoder->num_nullable_words());
 
   /* Due to the nature of SAT solving, we cannot know in advance the
    * number of linkages. But in order to process batch files, we must
@@ -1900,24 +2182,34 @@ extern "C" int sat_parse(Sentence sent, Parse_Options  opts)
    * overhead to an interactive user. It also doesn't add overhead to
    * batch processing, which needs anyway to find out if there is a
    * valid linkage in order to be any useful. */
-  for (k = 0; k < linkage_limit; k++)
+  for (size_t nl = opts->min_null_count; nl <= max_null_count; nl++)
   {
-    lkg = encoder->get_next_linkage();
-    if (lkg == NULL || lkg->lifo.N_violations == 0) break;
+    sat_free_linkages(sent, encoder->_next_linkage_index);
+    encoder->_next_linkage_index = 0;
+    sent->null_count = nl;
+    encoder->start_round(nl);
+
+    for (k = 0; k < linkage_limit; k++)
+    {
+      lkg = encoder->get_next_linkage();
+      if (lkg == NULL || lkg->lifo.N_violations == 0) break;
+    }
+    if (lkg != NULL && k < linkage_limit) break;
+    if (resources_exhausted(opts->resources)) break;
+
+    if ((0 == nl) && (0 < max_null_count) && verbosity > 0)
+      prt_error("No complete linkages found.\n");
   }
 
+  lgdebug(D_USER_TIMES, "Info: SAT: %u solver calls, %u disconnected and "
+          "%u insane solutions rejected\n", encoder->_num_solves,
+          encoder->_num_disconnected, encoder->_num_insane);
+
   if (lkg == NULL || k == linkage_limit) {
     // We don't have a valid linkages among the first linkage_limit ones
     sent->num_valid_linkages = 0;
     sent->num_linkages_found = k;
     sent->num_linkages_post_processed = k;
-    if (opts->max_null_count > 0) {
-      // The sat solver doesn't support (yet) parsing with nulls.
-      if (opts->verbosity >= 1)
-      prt_error("Info: use-sat: Cannot parse with null links (yet).\n"
-                "              Set the \"null\" option to 0 to turn off "
-                "parsing with null links.\n");
-    }
   } else {
     /* We found a valid linkage. However, we actually don't know yet the
      * number of linkages, and if we set them too low, the command-line
@@ -21,10 +21,12 @@ public:
       _opts(opts), _sent(sent)
   {
     _cost_cutoff = parse_options_get_disjunct_cost(opts);
+    _short_length = opts->short_length;
+    _all_short = opts->all_short;
+    _perform_pp_prune = opts->perform_pp_prune;
+    _eager_constraints = opts->sat_eager_constraints;
 
-    verbosity = opts->verbosity;
-    debug = opts->debug;
-    test = opts->test;
+    set_parse_options(opts);
 
     // Preprocess word tags of the sentence
     build_word_tags();
@@ -39,19 +41,40 @@ public:
   // Create the formula from the sentence
   void encode();
 
+  // Can the formula be used again for parsing the sentence with the
+  // given options? (It cannot if the expressions of the sentence may
+  // have been pruned differently, or if it was encoded for a lower
+  // cost cutoff.)
+  bool reusable(Parse_Options opts) const;
+
+  // Use the given options for the next parse of the sentence.
+  void set_parse_options(Parse_Options opts);
+
+  // Set the assumptions for finding the linkages that have exactly
+  // null_count null words, and start a new linkage enumeration.
+  void start_round(size_t null_count);
+
+  // The number of words that may be null words.
+  size_t num_nullable_words() const { return _nullable_words.size(); }
+
   // Solve the formula, returning the next linkage.
   Linkage get_next_linkage();
 
   // Next linkage index in the linkage array
   LinkageIdx _next_linkage_index = 0;
 
-private:
+  // Statistics of the linkage search: the number of solver calls, and
+  // the number of solutions that were rejected for being disconnected
+  // or morphologically insane.
+  unsigned int _num_solves = 0;
+  unsigned int _num_disconnected = 0;
+  unsigned int _num_insane = 0;
+
+protected:
   int verbosity;
   const char *debug;
   const char *test;
 
-protected:
-
   /**
    *  Methods that generate various link-grammar constraints.
    */
@@ -60,20 +83,21 @@ protected:
   // word in the sentence
   void generate_satisfaction_conditions();
 
-  // Generates satisfaction conditions for the word-tag expression e
-  void generate_satisfaction_for_expression(int w, int& dfs_position, Exp* e, char* var,
+  // Generates satisfaction conditions for the word-tag expression e,
+  // whose expression node (see Variables::exp_node_children()) is var
+  void generate_satisfaction_for_expression(int w, int& dfs_position, Exp* e, int var,
                                             double parent_cost);
 
   // Handle the case of NULL expression of a word
   virtual void handle_null_expression(int w) = 0;
 
   // Determine if this word-tag must be satisfied and generate appropriate clauses
-  virtual void determine_satisfaction(int w, char* name) = 0;
+  virtual void determine_satisfaction(int w, int var) = 0;
 
   // Generates satisfaction condition for the connector (wi, pi)
   virtual void generate_satisfaction_for_connector(int wi, int pi, 
                                                    Exp* e,
-                                                   char* var) = 0;
+                                                   int var) = 0;
 
   // Definition of link_cw((wi, pi), wj) variables when wj is an ordinary word
   void generate_link_cw_ordinary_definition(size_t wi, int pi,
@@ -157,6 +181,18 @@ protected:
   // have the specified connectivity components.
   void generate_disconnectivity_prohibiting(std::vector<int> components);
 
+  // Generate clauses that require each span of words that doesn't
+  // include the first word to be linked to a word outside of it. These
+  // are implied by the connectivity, and in the absence of optional
+  // words they are equivalent to it, so most of the linkages need not
+  // be checked by connectivity_components().
+  void generate_span_connectivity();
+
+  // Generate clauses that prohibit using in the same linkage words that
+  // originate from different tokenization alternatives, so most of the
+  // linkages need not be rejected by sane_linkage_morphism().
+  void generate_alternatives_consistency();
+
 
   /**
    *   Encoding specific clauses - override to add clauses that are
@@ -178,7 +214,7 @@ protected:
   // Generate definition of epsilon variables that are used for power
   // pruning
   void generate_epsilon_definitions();
-  bool generate_epsilon_for_expression(int w, int& dfs_position, Exp* e, char* var, bool root, char dir);
+  bool generate_epsilon_for_expression(int w, int& dfs_position, Exp* e, int var, bool root, char dir);
 
 
   // Power pruning
@@ -193,6 +229,38 @@ protected:
   // during satisfaction condition generating.
   double _cost_cutoff;
 
+  // The nodes whose total cost exceeds _cost_cutoff are disabled by a
+  // guard variable per distinct cost, which is set by an assumption, so
+  // the formula can be used again with a higher cost cutoff.
+  std::map<double, int> _cost_guards;
+  void generate_cost_cutoff(Lit lhs, double total_cost);
+
+  // The options (other than the cost cutoff) that the formula depends on.
+  size_t _short_length;
+  bool _all_short;
+  bool _perform_pp_prune;
+  bool _eager_constraints;
+  std::vector<const X_node*> _word_xnodes;
+
+  /**
+   *   Null words
+   *   The non-optional words may be null words. Their number is
+   *   bounded by assumptions on a sequential counter, whose columns
+   *   are generated on demand.
+   */
+  std::vector<int> _nullable_words;
+  std::vector<std::vector<Lit>> _null_counter;
+  int _false_var = -1;
+
+  // A literal that is true iff there are at least k null words.
+  Lit null_count_at_least(size_t k);
+  Lit false_literal();
+
+  // The assumptions of the current round. The clauses that prohibit
+  // the linkages found in a round are guarded by its _round_var.
+  vec<Lit> _assumptions;
+  int _round_var = -1;
+
   /**
    *   Creating clauses and passing them to the MiniSAT solver
    */
@@ -202,14 +270,18 @@ protected:
 #ifdef SAT_DEBUG
     print_clause(clause);
 #endif
-    for (int i = 0; i < clause.size(); i++) {
-      while (var(clause[i]) >= _solver->nVars()) {
-        _solver->newVar();
-      }
-    }
+    for (int i = 0; i < clause.size(); i++)
+      add_variable(var(clause[i]));
     _solver->addClause(clause);
   }
 
+  // Create the solver variables up to the specified one
+  void add_variable(int v) {
+    while (v >= _solver->nVars()) {
+      _solver->newVar();
+    }
+  }
+
 
   // Print clause literals to standard output
   static void print_clause(const vec<Lit>& clause) {
@@ -283,6 +355,9 @@ protected:
   // Generate clause that prohibits the current model
   void generate_linkage_prohibiting();
 
+  // Find the next model, unless the parse resources are exhausted
+  bool solve();
+
   // Object that contains all information about the variable
   // encoding.
   Variables* _variables;
@@ -319,17 +394,13 @@ public:
     _solver->restart_first = 100;
     _solver->var_decay = 0.99;
 #endif
-
-    verbosity = opts->verbosity;
-    debug = opts->debug;
-    test = opts->test;
   }
 
   virtual void handle_null_expression(int w);
-  virtual void determine_satisfaction(int w, char* name);
+  virtual void determine_satisfaction(int w, int var);
   virtual void generate_satisfaction_for_connector(int wi, int pi,
                                                    Exp* e,
-                                                   char* var);
+                                                   int var);
 
 
   virtual void generate_linked_definitions();
@@ -337,10 +408,5 @@ public:
   virtual Exp* PositionConnector2exp(const PositionConnector*);
 
   virtual void generate_encoding_specific_clauses();
-
-private:
-  int verbosity;
-  const char *debug;
-  const char *test;
 };
 
@@ -4,6 +4,7 @@
 #include <ctype.h>
 #include <vector>
 #include <map>
+#include <string>
 #include <iostream>
 
 using std::cout;
@@ -11,11 +12,7 @@ using std::cerr;
 using std::endl;
 
 #include "guiding.hpp"
-#include "trie.hpp"
 #include "matrix-ut.hpp"
-#include "fast-sprintf.hpp"
-
-#define  MAX_VARIABLE_NAME 256
 
 extern "C"
 {
@@ -69,7 +66,10 @@ class Variables
 {
 public:
   Variables(Sentence sent)
-    : _link_variable_map(sent->length)
+    : _exp_node_first_child(sent->length, -1)
+    ,_exp_node_variables(sent->length, -1)
+    ,_link_variable_map(sent->length)
+    ,_link_variable_wp_map(sent->length)
     ,_linked_variable_map(sent->length, -1)
     ,_linked_min_variable_map(sent->length, -1)
     ,_linked_max_variable_map(sent->length, -1)
@@ -81,6 +81,14 @@ public:
     ,_guiding(new CostDistanceGuiding(sent))
     ,_var(0)
   {
+    _exp_node_epsilon_variables[0].resize(sent->length, -1);
+    _exp_node_epsilon_variables[1].resize(sent->length, -1);
+    _linked_beyond_variable_map[0].resize(sent->length, -1);
+    _linked_beyond_variable_map[1].resize(sent->length, -1);
+#ifdef _VARS
+    for (size_t w = 0; w < sent->length; w++)
+      _exp_node_names.push_back("w" + std::to_string(w));
+#endif
   }
 
   ~Variables() {
@@ -100,40 +108,73 @@ public:
 
 
   /*
-   * General purpose variables specified by their names
+   * Expression nodes
+   * The nodes of the expression of each word are identified by numbers:
+   * node w is the root of the expression of word w, and the children of
+   * a node get consecutive numbers when they are first asked for.
+   * (The unary AND and OR nodes are skipped, and have the number of
+   * their parent.) The variables of the nodes are kept in tables that
+   * are indexed by the node numbers.
    */
 
-  bool var_exists(const char* name) {
-    try {
-      int num = _variable_trie.lookup(name);
-      return num != Trie<int>::NOT_FOUND;
-      } catch (const std::string& s) {
-          cout << s << endl;
-          exit(EXIT_FAILURE);
-        }
+  // Returns the number of the first child of the given node, whose
+  // expression is e (an AND or OR node with at least two children).
+  int exp_node_children(int node, const Exp* e) {
+    int first = _exp_node_first_child[node];
+    if (first == -1) {
+      int n = 0;
+      for (E_list* l = e->u.l; l != NULL; l = l->next) n++;
+
+      first = _exp_node_variables.size();
+      _exp_node_first_child[node] = first;
+      _exp_node_first_child.resize(first + n, -1);
+      _exp_node_variables.resize(first + n, -1);
+      _exp_node_epsilon_variables[0].resize(first + n, -1);
+      _exp_node_epsilon_variables[1].resize(first + n, -1);
+#ifdef _VARS
+      char type = (e->type == AND_type) ? 'c' : 'd';
+      for (int i = 0; i < n; i++)
+        _exp_node_names.push_back(_exp_node_names[node] + type + std::to_string(i));
+#endif
+    }
+    return first;
   }
 
+  /*
+   * Variables that specify that an expression node is satisfied
+   * (historically named "string" variables).
+   */
+
   // If guiding params are unknown, they are set do default
-  int string(const char* name)
+  int string(int node)
   {
     int var;
-    if (!get_var_from_trie(name, var)) {
+    if (!get_exp_node_variable(node, _exp_node_variables, var)) {
 #ifdef _VARS
-      var_defs_stream << name << "\t" << var << endl;
+      var_defs_stream << _exp_node_names[node] << "\t" << var << endl;
 #endif
-      _guiding->setStringParameters(var, name);
+      _guiding->setStringParameters(var);
     }
     assert(var != -1, "Var == -1");
     return var;
   }
 
+  // The root node variable of a non-optional word. It is false iff the
+  // word is a null word.
+  int word(int w)
+  {
+    int var = string(w);
+    _guiding->setWordParameters(var);
+    return var;
+  }
+
   // If the cost is explicitly given, guiding params are calculated
   // using the cost. Any params set earlier are overridden.
-  int string_cost(const char* name, double cost)
+  int string_cost(int node, double cost)
   {
     int var;
-    var = string(name);
-    _guiding->setStringParameters(var, name, cost);
+    var = string(node);
+    _guiding->setStringParameters(var, cost);
     assert(var != -1, "Var == -1");
     return var;
   }
@@ -144,17 +185,12 @@ public:
    */
 
   // If guiding params are unknown, they are set do default
-  int epsilon(char* v, char dir) {
-    char name[MAX_VARIABLE_NAME];
-    dir = (dir == '+') ? 'r' : 'l';
-    char* s = name;
-    *s++ = dir;
-    *s++ = 'e';
-    s = fast_sprintf(s, v);
+  int epsilon(int node, char dir) {
     int var;
-    if (!get_var_from_trie(name, var)) {
+    if (!get_exp_node_variable(node, _exp_node_epsilon_variables[dir == '+'], var)) {
 #ifdef _VARS
-      var_defs_stream << name << "\t" << var << endl;
+      var_defs_stream << ((dir == '+') ? "re" : "le") << _exp_node_names[node]
+                      << "\t" << var << endl;
 #endif
       _guiding->setEpsilonParameters(var);
     }
@@ -162,6 +198,30 @@ public:
     return var;
   }
 
+  /*
+   * Variables that specify that a link exists if the given optional
+   * words exist (lw/rw is 255 if the left/right word is not optional).
+   * They are used in the clauses that prohibit disconnected linkages.
+   */
+
+  // Returns false if the variable has just been created
+  bool conditional_link(int link_var, int lw, int rw, int& var) {
+    std::pair<int, std::pair<int, int> > p(link_var, std::pair<int, int>(lw, rw));
+    std::map<std::pair<int, std::pair<int, int> >, int>::iterator it =
+      _conditional_link_variables.find(p);
+    if (it != _conditional_link_variables.end()) {
+      var = it->second;
+      return true;
+    }
+    var = get_fresh_var();
+#ifdef _VARS
+    var_defs_stream << "0" << link_var << "w" << lw << "w" << rw << "\t" << var << endl;
+#endif
+    _guiding->setStringParameters(var);
+    _conditional_link_variables[p] = var;
+    return false;
+  }
+
   /*
    *             linked(wi, wj)
    * Variables that specify that two words are linked
@@ -195,6 +255,58 @@ public:
     return var;
   }
 
+  /*
+   *             linked_beyond(w, b, dir)
+   * Variables that specify that the word w is linked to some word after
+   * the word b (dir is '+') or before it (dir is '-').
+   * They are used in the eager connectivity constraints.
+   */
+  int linked_beyond(int w, int b, char dir) {
+    int var;
+    if (!get_2int_variable(w, b, var, _linked_beyond_variable_map[dir == '+'])) {
+#ifdef _VARS
+      var_defs_stream << "linked_beyond" << dir << "_" << w << "_" << b << "\t" << var << endl;
+#endif
+      _guiding->setLinkedMinMaxParameters(var, w, b);
+    }
+    assert(var != -1, "Var == -1");
+    return var;
+  }
+
+  /*
+   *             word_alternative(w, i)
+   * Variables that specify that the word w is in the linkage as its i'th
+   * distinct wordgraph word (when its X_nodes originate from more than
+   * one wordgraph word). They are used in the eager morphology constraints.
+   */
+  int word_alternative(int w, int i) {
+    std::pair<int, int> p(w, i);
+    std::map<std::pair<int, int>, int>::iterator it = _word_alternative_variables.find(p);
+    if (it != _word_alternative_variables.end())
+      return it->second;
+
+    int var = get_fresh_var();
+#ifdef _VARS
+    var_defs_stream << "word_alternative_" << w << "_" << i << "\t" << var << endl;
+#endif
+    _guiding->setStringParameters(var);
+    _word_alternative_variables[p] = var;
+    return var;
+  }
+
+  /*
+   * Auxiliary variables, used in the definitions of the null word
+   * counter and as assumption literals.
+   */
+  int auxiliary() {
+    int var = get_fresh_var();
+#ifdef _VARS
+    var_defs_stream << "aux_" << var << "\t" << var << endl;
+#endif
+    _guiding->setStringParameters(var);
+    return var;
+  }
+
 #if 0
   // If guiding params are unknown, they are set do default
   int linked_min(int wi, int wj) {
@@ -326,15 +438,16 @@ public:
 
   // Variables that specify that words i and j are connected
   int con(int i, int j) {
-    char name[MAX_VARIABLE_NAME];
-    char* s = name;
-    *s++ = 'c';
-    s = fast_sprintf(s, i);
-    *s++ = '_';
-    s = fast_sprintf(s, j);
     int var;
-    if (!get_var_from_trie(name, var))
+    std::pair<int, int> p(i, j);
+    std::map<std::pair<int, int>, int>::iterator it = _con_variables.find(p);
+    if (it != _con_variables.end()) {
+      var = it->second;
+    } else {
+      var = get_fresh_var();
+      _con_variables[p] = var;
       set_variable_sat_params(var, false);
+    }
     return var;
   }
 
@@ -357,8 +470,10 @@ public:
 
   // Returns the indices of all link_x_x_wj_pj variables
   const std::vector<int>& link_variables(int wj, int pj) {
-    std::pair<int, int> p(wj, pj);
-    return _link_variable_wp_map[p];
+    static const std::vector<int> none;
+    std::vector< std::vector<int> >& m = _link_variable_wp_map[wj];
+    if ((size_t)pj >= m.size()) return none;
+    return m[pj];
   }
 
   // Additional info about the link(wi, pi, wj, pj) variable
@@ -446,6 +561,11 @@ public:
   }
 #endif
 
+  // The number of variables allocated so far
+  size_t size() const {
+    return _var;
+  }
+
   /* Pass SAT search parameters to the MiniSAT solver */
   void setVariableParameters(Solver* solver) {
     _guiding->passParametersToSolver(solver);
@@ -453,11 +573,25 @@ public:
 
 private:
   /*
-   * Information about string variables
+   * Information about the expression nodes
    */
 
-  // What is the number of the variable with the given name?
-  Trie<int> _variable_trie;
+  // What is the number of the first child of the node?
+  std::vector<int> _exp_node_first_child;
+
+  // What is the number of the variable of the node?
+  std::vector<int> _exp_node_variables;
+
+  // What are the numbers of its left and right epsilon variables?
+  std::vector<int> _exp_node_epsilon_variables[2];
+
+#ifdef _VARS
+  // The node names, for printing the variables
+  std::vector<std::string> _exp_node_names;
+#endif
+
+  // What is the number of the conditional link variable?
+  std::map<std::pair<int, std::pair<int, int> >, int> _conditional_link_variables;
 
   /*
    * Information about link(wi, pi, wj, pj) variables
@@ -471,7 +605,8 @@ private:
   std::vector<int>  _link_variables_indices;
 
   // What are the numbers of all link(x, x, wj, pj) variables?
-  std::map< std::pair<int, int>, std::vector<int> > _link_variable_wp_map;
+  // (Indexed by wj and then pj.)
+  std::vector< std::vector< std::vector<int> > > _link_variable_wp_map;
 
 
   // Additional info about the link(wi, pi, wj, pj) variable with the given number
@@ -481,32 +616,12 @@ private:
   void add_link_variable(int i, int pi, const char* ci, Exp* ei,
                          int j, int pj, const char* cj, Exp* ej, size_t var)
   {
-  /* The following variable is created but is never inserted to the trie,
-     and generating it has an observable performance impact.
-     The trie even doesn't have 'k'. */
-#if 0
-    char name[MAX_VARIABLE_NAME];
-    char* s = name;
-    *s++ = 'l';    *s++ = 'i';     *s++ = 'n';     *s++ = 'k';
-    *s++ = '_';
-    s = fast_sprintf(s, i);
-    *s++ = '_';
-    s = fast_sprintf(s, pi);
-    *s++ = '_';
-    s = fast_sprintf(s, ci);
-    *s++ = '_';
-    s = fast_sprintf(s, j);
-    *s++ = '_';
-    s = fast_sprintf(s, pj);
-    *s++ = '_';
-    s = fast_sprintf(s, cj);
-#endif
     char* label = construct_link_label(ci, cj);
 
     if (var >= _link_variables.size()) {
       _link_variables.resize(var + 1, 0);
     }
-    // The first argument was the redundant variable eliminated above
+    // The link variable names are not generated (they are not needed)
     _link_variables[var] = new LinkVar("", label, i, pi, j, pj, ci, cj, ei, ej);
     _link_variables_indices.push_back(var);
   }
@@ -539,6 +654,13 @@ private:
   // What is the number of the linked_max(i, j) variable?
   Matrix<int> _linked_max_variable_map;
 
+  // What is the number of the linked_beyond(w, b, dir) variable?
+  // (Indexed by dir == '+'.)
+  Matrix<int> _linked_beyond_variable_map[2];
+
+  // What is the number of the word_alternative(w, i) variable?
+  std::map<std::pair<int, int>, int> _word_alternative_variables;
+
   /*
    * Information about the thin_link(i, j) variables
    */
@@ -551,7 +673,7 @@ private:
    */
 
   // What is the number of the link_top_cw(wi, wj, pj) variable?
-  Matrix< std::map<int, int> > _link_top_cw_variable_map;
+  Matrix< std::vector<int> > _link_top_cw_variable_map;
 
   // What are the numbers of all link_top_cw(wi, wj, pj) variables?
   std::vector<int>  _link_top_cw_variables_indices;
@@ -563,19 +685,8 @@ private:
 #if 0
   // Set this additional info
   void add_link_top_cw_variable(int i, int j, int pj, const char* cj, size_t var) {
-    char name[MAX_VARIABLE_NAME];
-    char* s = name;
-    *s++ = 'l';    *s++ = 'i';     *s++ = 'n';     *s++ = 'k'; *s++ = '_'; *s++ = 't'; *s++ = 'o'; *s++ = 'p';
-    *s++ = '_';
-    s = fast_sprintf(s, i);
-    *s++ = '_'; *s++ = '(';
-    s = fast_sprintf(s, j);
-    *s++ = '_';
-    s = fast_sprintf(s, pj);
-    *s++ = '_';
-    s = fast_sprintf(s, cj);
-    *s++ = ')';
-    *s = '\0';
+    std::string name = "link_top_" + std::to_string(i) + "_(" +
+      std::to_string(j) + "_" + std::to_string(pj) + "_" + cj + ")";
 
     if (var >= _link_top_cw_variables.size()) {
       _link_top_cw_variables.resize(var + 1, 0);
@@ -589,10 +700,12 @@ private:
    *   Information about the link_cw(w, wj, pj) variables
    */
   // What is the number of the link_cw(wi, wj, pj) variable?
-  Matrix< std::map<int, int> > _link_cw_variable_map;
+  // (Indexed by wi and wj, and then pj.)
+  Matrix< std::vector<int> > _link_cw_variable_map;
 
 
 #ifdef _CONNECTIVITY_
+  std::map<std::pair<int, int>, int> _con_variables;
   std::map<std::pair<std::pair<int, int>,int>, int> _lcon_variables;
 #endif
 
@@ -612,22 +725,14 @@ private:
      fresh variable number, and false is returned. Otherwise, the number
      is retrieved and true is returned. */
 
-  bool get_var_from_trie(const char* name, int& var) {
-    try {
-      int num = _variable_trie.lookup(name);
-      if (num != Trie<int>::NOT_FOUND) {
-        var = num;
-        return true;
-      }
-      else {
-        var = get_fresh_var();
-        _variable_trie.insert(name, var);
-        return false;
-      }
-    } catch (const std::string& s) {
-      cout << s << endl;
-      exit(EXIT_FAILURE);
+  bool get_exp_node_variable(int node, std::vector<int>& vars, int& var) {
+    var = vars[node];
+    if (var == -1) {
+      var = get_fresh_var();
+      vars[node] = var;
+      return false;
     }
+    return true;
   }
 
 
@@ -643,17 +748,16 @@ private:
   }
 
   bool get_3int_variable(int i, int j, int pj, int& var,
-                         Matrix< std::map<int, int> >& mp) {
-    std::map<int, int>& m = mp(i, j);
-    std::map<int, int>::iterator it = m.find(pj);
-    if (it == m.end()) {
+                         Matrix< std::vector<int> >& mp) {
+    std::vector<int>& v = mp(i, j);
+    if ((size_t)pj >= v.size()) v.resize(pj + 1, -1);
+    var = v[pj];
+    if (var == -1) {
       var = get_fresh_var();
-      m[pj] = var;
+      v[pj] = var;
       return false;
-    } else {
-      var = it->second;
-      return true;
     }
+    return true;
   }
 
   bool get_4int_variable(int i, int pi, int j, int pj, int& var,
@@ -674,8 +778,9 @@ private:
   bool get_link_variable(int i, int pi, int j, int pj, int& var) {
     bool ret = get_4int_variable(i, pi, j, pj, var, _link_variable_map);
     if (!ret) {
-      std::pair<int, int> p(j, pj);
-      _link_variable_wp_map[p].push_back(var);
+      std::vector< std::vector<int> >& m = _link_variable_wp_map[j];
+      if ((size_t)pj >= m.size()) m.resize(pj + 1);
+      m[pj].push_back(var);
     }
     return ret;
   }
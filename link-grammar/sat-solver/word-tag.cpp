@@ -1,5 +1,4 @@
 #include "word-tag.hpp"
-#include "fast-sprintf.hpp"
 
 extern "C" {
 #ifdef DEBUG
@@ -16,14 +15,14 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
                                 bool& leading_right, bool& leading_left,
                                 std::vector<int>& eps_right,
                                 std::vector<int>& eps_left,
-                                char* var, bool root, double parent_cost,
+                                int var, bool root, double parent_cost,
                                 Exp* parent_exp, const X_node *word_xnode)
 {
   double cost = parent_cost + exp->cost;
 
 #ifdef DEBUG
   if (0 && verbosity_level(+D_IC)) { // Extreme debug
-    printf("Expression type %d for Word%d, var %s:\n", exp->type, _word, var);
+    printf("Expression type %d for Word%d, var %d:\n", exp->type, _word, var);
     printf("parent_exp: "); print_expression(parent_exp);
     printf("exp: "); print_expression(exp);
   }
@@ -65,29 +64,18 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
       } else {
         int i;
         E_list* l;
-
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while ((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
+        int child = _variables->exp_node_children(var, exp);
 
         for (i = 0, l = exp->u.l; l != NULL; l = l->next, i++) {
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-
           insert_connectors(l->e, dfs_position, leading_right, leading_left,
-                eps_right, eps_left, new_var, false, cost, parent_exp, word_xnode);
+                eps_right, eps_left, child + i, false, cost, parent_exp, word_xnode);
 
 #ifdef POWER_PRUNE_CONNECTORS
           if (leading_right) {
-            eps_right.push_back(_variables->epsilon(new_var, '+'));
+            eps_right.push_back(_variables->epsilon(child + i, '+'));
           }
           if (leading_left) {
-            eps_left.push_back(_variables->epsilon(new_var, '-'));
+            eps_left.push_back(_variables->epsilon(child + i, '-'));
           }
 #endif
         }
@@ -102,18 +90,11 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
       E_list* l;
       bool ll_true = false;
       bool lr_true = false;
-
-      char new_var[MAX_VARIABLE_NAME];
-      char* last_new_var = new_var;
-      char* last_var = var;
-      while ((*last_new_var = *last_var)) {
-        last_new_var++;
-        last_var++;
-      }
+      int child = _variables->exp_node_children(var, exp);
 
 #ifdef DEBUG
       if (0 && verbosity_level(+D_IC)) { // Extreme debug
-        printf("Word%d, var %s OR_type:\n", _word, var);
+        printf("Word%d, var %d OR_type:\n", _word, var);
         printf("exp mem: "); prt_exp_mem(exp, 0);
       }
 #endif
@@ -122,13 +103,9 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
         bool lr = leading_right, ll = leading_left;
         std::vector<int> er = eps_right, el = eps_left;
 
-        char* s = last_new_var;
-        *s++ = 'd';
-        fast_sprintf(s, i);
-
-        lgdebug(+D_IC, "Word%d: var: %s; exp%d=%p; X_node: %s\n",
+        lgdebug(+D_IC, "Word%d: var: %d; exp%d=%p; X_node: %s\n",
                 _word, var, i, l, word_xnode ? word_xnode->word->subword : "NULL X_node");
-        assert(word_xnode != NULL, "NULL X_node for var %s", new_var);
+        assert(word_xnode != NULL, "NULL X_node for var %d", child + i);
         if (root && parent_exp == NULL && l->e != word_xnode->exp) {
           E_list *we = NULL;
 
@@ -143,7 +120,7 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
             word_xnode = word_xnode->next;
           }
         }
-        insert_connectors(l->e, dfs_position, lr, ll, er, el, new_var, false, cost, l->e, word_xnode);
+        insert_connectors(l->e, dfs_position, lr, ll, er, el, child + i, false, cost, l->e, word_xnode);
 
         if (lr)
           lr_true = true;
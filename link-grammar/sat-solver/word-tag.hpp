@@ -3,7 +3,6 @@
 
 #include <vector>
 #include <map>
-#include <set>
 
 extern "C" {
 #include "connectors.h"
@@ -103,19 +102,22 @@ private:
   Parse_Options _opts;
 
   // Could this word tag match a connector (wi, pi)?
-  // For each word wi I keep a set of positions pi that can be matched
-  std::vector< std::set<int> > _match_possible;
+  // For each word wi I keep the positions pi that can be matched
+  // (indexed by wi and then pi)
+  std::vector< std::vector<bool> > _match_possible;
   void set_match_possible(int wj, int pj) {
-    _match_possible[wj].insert(pj);
+    std::vector<bool>& m = _match_possible[wj];
+    if ((size_t)pj >= m.size()) m.resize(pj + 1, false);
+    m[pj] = true;
   }
 
 public:
-  WordTag(int word, const char* name, Variables* variables, Sentence sent, Parse_Options opts)
+  WordTag(int word, Variables* variables, Sentence sent, Parse_Options opts)
     : _word(word), _variables(variables), _sent(sent), _opts(opts) {
     _match_possible.resize(_sent->length);
 
     // The SAT word variables are set to be equal to the word numbers.
-    Var var = _variables->string(name);
+    Var var = _variables->string(word);
     assert(word == var);
 
     verbosity = opts->verbosity;
@@ -173,7 +175,7 @@ public:
                          bool& leading_right, bool& leading_left,
                          std::vector<int>& eps_right,
                          std::vector<int>& eps_left,
-                         char* var, bool root, double parent_cost,
+                         int var, bool root, double parent_cost,
                          Exp* parent, const X_node *word_xnode);
 
   // Caches information about the found matches to the _matches vector, and also
@@ -190,7 +192,8 @@ public:
   // It is assumed that
   bool match_possible(int wi, int pi)
   {
-    return _match_possible[wi].find(pi) != _match_possible[wi].end();
+    const std::vector<bool>& m = _match_possible[wi];
+    return ((size_t)pi < m.size()) && m[pi];
   }
 
 private:
@@ -118,6 +118,10 @@ typedef enum
 
 #define MAX_SPLITS 10   /* See split_counter below */
 
+/* Number of next/prev words that are kept in the Gword itself.
+ * Longer lists are allocated separately (see gword_next_append()). */
+#define GWORD_INLINE_LIST 2
+
 struct Gword_struct
 {
 	const char *subword;
@@ -128,6 +132,8 @@ struct Gword_struct
 	Gword **next;        /* Right-going tree */
 	Gword **prev;        /* Left-going tree */
 	Gword *chain_next;   /* Next word in the chain of all words */
+	Gword *next_inline[GWORD_INLINE_LIST+1]; /* Storage for short next */
+	Gword *prev_inline[GWORD_INLINE_LIST+1]; /* Storage for short prev */
 
 	/* Disjuncts and connectors point back to their originating Gword(s). */
 	gword_set gword_set_head;
@@ -776,10 +776,10 @@ Gword *issue_word_alternative(Sentence sent, Gword *unsplit_word,
 
 				/* Scan its "prev" words and add it as their "next" word */
 				for (q = unsplit_word->prev; *q; q++)
-					gwordlist_append(&(*q)->next, unsplit_word);
+					gword_next_append(*q, unsplit_word);
 				/* Scan its "next" words and add it as their "prev" word */
 				for (q = unsplit_word->next; *q; q++)
-					gwordlist_append(&(*q)->prev, unsplit_word);
+					gword_prev_append(*q, unsplit_word);
 				word_label(sent, unsplit_word, "+", label);
 				word_label(sent, unsplit_word, NULL, "R");
 				unsplit_word->status |= WS_UNSPLIT;
@@ -879,11 +879,11 @@ Gword *issue_word_alternative(Sentence sent, Gword *unsplit_word,
 						Gword **n;
 
 						/* Create the "prev" link for subword */
-						gwordlist_append(&subword->prev, *p);
+						gword_prev_append(subword, *p);
 
 						if (unsplit_word->status & WS_HASALT)
 						{
-							gwordlist_append(&(*p)->next, subword);
+							gword_next_append(*p, subword);
 						}
 						else
 						{
@@ -925,11 +925,11 @@ Gword *issue_word_alternative(Sentence sent, Gword *unsplit_word,
 						Gword **p;
 
 						/* Create the "next" link for subword */
-						gwordlist_append(&subword->next, *n);
+						gword_next_append(subword, *n);
 
 						if (unsplit_word->status & WS_HASALT)
 						{
-							gwordlist_append(&(*n)->prev, subword);
+							gword_prev_append(*n, subword);
 						}
 						else
 						{
@@ -966,8 +966,8 @@ Gword *issue_word_alternative(Sentence sent, Gword *unsplit_word,
 						subword->end = subword->start + strlen_cache[ai];
 					}
 
-					gwordlist_append(&psubword->next, subword);
-					gwordlist_append(&subword->prev, psubword);
+					gword_next_append(psubword, subword);
+					gword_prev_append(subword, psubword);
 				}
 
 				subword->alternative_id = alternative_id;
@@ -2795,8 +2795,8 @@ static Gword *issue_sentence_word(const Sentence sent, const char *const s)
 	new_word->unsplit_word = sent->wordgraph;
 	new_word->label = "S"; /* a sentence word */
 
-	gwordlist_append(&last_word->next, new_word);
-	gwordlist_append(&new_word->prev, last_word);
+	gword_next_append(last_word, new_word);
+	gword_prev_append(new_word, last_word);
 
 	gwordqueue_add(sent, new_word);
 
@@ -3035,7 +3035,8 @@ static X_node * build_word_expressions(Sentence sent, const Gword *w, const char
 	Exp_list eli;
 	const Dictionary dict = sent->dict;
 
-	eli.exp_list = NULL;
+	eli.Exp_pool = NULL;
+	eli.E_list_pool = NULL;
 	dn_head = dictionary_lookup_list(dict, NULL == s ? w->subword : s);
 	x = NULL;
 	dn = dn_head;
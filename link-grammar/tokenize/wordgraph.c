@@ -22,11 +22,22 @@
 /* Many more Gword utilities, that are used only in particular files,
  * are defined in these files statically. */
 
+/**
+ * Allocate a new wordgraph word.
+ * The words are allocated from a per-sentence pool, which is freed in
+ * one shot by wordgraph_delete().
+ */
 Gword *gword_new(Sentence sent, const char *s)
 {
-	Gword *gword = malloc(sizeof(*gword));
+	if (NULL == sent->Gword_pool)
+	{
+		sent->Gword_pool = pool_new(__func__, "Gword",
+		                            /*num_elements*/64, sizeof(Gword),
+		                            /*zero_out*/true, /*align*/false,
+		                            /*exact*/false);
+	}
+	Gword *gword = pool_alloc(sent->Gword_pool);
 
-	memset(gword, 0, sizeof(*gword));
 	assert(NULL != s, "Null-string subword");
 	gword->subword = string_set_add(s, sent->string_set);
 
@@ -78,6 +89,45 @@ void gwordlist_append(Gword ***arrp, Gword *p)
 	(*arrp)[n] = p;
 }
 
+/**
+ * Append a word to a next/prev list that starts in the given inline
+ * storage of GWORD_INLINE_LIST+1 elements (zeroed out at word creation).
+ * When the list gets longer it is moved to an allocated array.
+ */
+static void gwordlist_inline_append(Gword ***arrp, Gword **inline_arr, Gword *p)
+{
+	size_t n = gwordlist_len((const Gword **)*arrp);
+
+	if (n < GWORD_INLINE_LIST)
+	{
+		*arrp = inline_arr;
+		inline_arr[n] = p; /* The terminating NULL is already there. */
+		return;
+	}
+
+	if (*arrp == inline_arr)
+	{
+		*arrp = malloc((n+2) * sizeof(Gword *));
+		memcpy(*arrp, inline_arr, n * sizeof(Gword *));
+	}
+	else
+	{
+		*arrp = realloc(*arrp, (n+2) * sizeof(Gword *));
+	}
+	(*arrp)[n] = p;
+	(*arrp)[n+1] = NULL;
+}
+
+void gword_next_append(Gword *w, Gword *p)
+{
+	gwordlist_inline_append(&w->next, w->next_inline, p);
+}
+
+void gword_prev_append(Gword *w, Gword *p)
+{
+	gwordlist_inline_append(&w->prev, w->prev_inline, p);
+}
+
 #if 0
 /**
  * Append a Gword list to a given Gword list (w/o duplicates).
@@ -506,17 +556,16 @@ void wordgraph_delete(Sentence sent)
 	Gword *w = sent->wordgraph;
 	gword_set_delete(w);
 
-	while (NULL != w)
+	/* The words themselves are in the Gword pool. */
+	for (; NULL != w; w = w->chain_next)
 	{
-		Gword *w_tofree = w;
-
-		free(w->prev);
-		free(w->next);
+		if (w->prev != w->prev_inline) free(w->prev);
+		if (w->next != w->next_inline) free(w->next);
 		free(w->hier_position);
 		free(w->null_subwords);
-		w = w->chain_next;
-		free(w_tofree);
 	}
+	pool_delete(sent->Gword_pool);
+	sent->Gword_pool = NULL;
 	sent->last_word = NULL;
 	sent->wordgraph = NULL;
 }
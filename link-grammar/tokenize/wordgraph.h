@@ -24,6 +24,8 @@ Gword *gword_new(Sentence, const char *);
 Gword *empty_word(void); /* FIXME: Remove it. */
 size_t gwordlist_len(const Gword **);
 void gwordlist_append(Gword ***, Gword *);
+void gword_next_append(Gword *, Gword *);
+void gword_prev_append(Gword *, Gword *);
 void gword_set_print(const gword_set *);
 void print_lwg_path(Gword **, const char *);
 Gword *wg_get_sentence_word(const Sentence, Gword *);
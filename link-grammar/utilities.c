@@ -35,6 +35,12 @@
 	#include <windows.h>
 #endif /* _WIN32 */
 
+#if defined HAVE_PTHREAD && defined HAVE_STDATOMIC_H
+#define PARALLEL_FOR
+#include <pthread.h>
+#include <stdatomic.h>
+#endif /* HAVE_PTHREAD && HAVE_STDATOMIC_H */
+
 #include "utilities.h"
 
 /* This file contains general utilities that fix, enhance OS-provided
@@ -483,6 +489,30 @@ void dyn_strcat(dyn_str* ds, const char *str)
 	ds->end += l;
 }
 
+/// Make room for at least n more bytes, so appending them will not
+/// need to reallocate the string.
+void dyn_str_reserve(dyn_str* ds, size_t n)
+{
+	if (ds->end+n+1 >= ds->len)
+	{
+		ds->len = ds->end + n + 2;
+		ds->str = realloc(ds->str, ds->len);
+	}
+}
+
+/// Append exactly n bytes of str (which must not contain a NUL in them).
+void dyn_strncat(dyn_str* ds, const char *str, size_t n)
+{
+	if (ds->end+n+1 >= ds->len)
+	{
+		ds->len = 2 * ds->len + n;
+		ds->str = realloc(ds->str, ds->len);
+	}
+	memcpy(ds->str+ds->end, str, n);
+	ds->end += n;
+	ds->str[ds->end] = 0x0;
+}
+
 /// Trim away trailing whitespace.
 void dyn_trimback(dyn_str* ds)
 {
@@ -669,6 +699,70 @@ size_t altlen(const char **arr)
 	return len;
 }
 
+/* ============================================================= */
+/* Parallel loops */
+
+#ifdef PARALLEL_FOR
+typedef struct
+{
+	void (*fn)(size_t, void *);
+	void *arg;
+	size_t n;
+	atomic_size_t next;
+} parallel_for_t;
+
+static void *parallel_for_worker(void *arg)
+{
+	parallel_for_t *pf = arg;
+
+	for (size_t i; (i = atomic_fetch_add(&pf->next, 1)) < pf->n; )
+		pf->fn(i, pf->arg);
+
+	return NULL;
+}
+#endif /* PARALLEL_FOR */
+
+/**
+ * Call fn(i, arg) for each i in 0..n-1, using up to nthreads threads
+ * (including the calling one). The iterations are handed out one at a
+ * time, in increasing order, so fn() must not depend on the order in
+ * which they run. If the library has been built without thread support,
+ * or nthreads is less than 2, the iterations are done in order in the
+ * calling thread.
+ */
+void parallel_for(size_t n, int nthreads, void (*fn)(size_t, void *),
+                  void *arg)
+{
+	if (0 == n) return;
+
+#ifdef PARALLEL_FOR
+	size_t num_workers = MIN((size_t)MAX(nthreads, 1), n) - 1;
+
+	if (0 < num_workers)
+	{
+		parallel_for_t pf = { .fn = fn, .arg = arg, .n = n };
+		pthread_t *worker = alloca(num_workers * sizeof(pthread_t));
+		size_t num_started;
+
+		atomic_init(&pf.next, 0);
+		for (num_started = 0; num_started < num_workers; num_started++)
+		{
+			if (0 != pthread_create(&worker[num_started], NULL,
+			                        parallel_for_worker, &pf))
+				break;
+		}
+
+		parallel_for_worker(&pf);
+		for (size_t i = 0; i < num_started; i++)
+			pthread_join(worker[i], NULL);
+		return;
+	}
+#endif /* PARALLEL_FOR */
+
+	for (size_t i = 0; i < n; i++)
+		fn(i, arg);
+}
+
 /* ============================================================= */
 
 #ifdef __MINGW32__
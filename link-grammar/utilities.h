@@ -206,6 +206,34 @@ void *aligned_alloc(size_t alignment, size_t size);
 #define MAX(X,Y)  ( ((X) > (Y)) ? (X) : (Y))
 #endif
 
+/* Atomic reference counts and a minimal spinlock, on a long.
+ * atomic_load_acquire() and atomic_store_release() are for publishing
+ * data through an int-sized flag (such as an enum) without a lock. */
+#if defined __GNUC__
+#define atomic_load_acquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define atomic_store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define refcount_inc(p) __atomic_add_fetch(p, 1, __ATOMIC_RELAXED)
+#define refcount_dec(p) __atomic_sub_fetch(p, 1, __ATOMIC_ACQ_REL)
+#define spin_lock(p) while (__atomic_exchange_n(p, 1, __ATOMIC_ACQUIRE)) {}
+#define spin_unlock(p) __atomic_store_n(p, 0, __ATOMIC_RELEASE)
+#elif defined _MSC_VER
+/* Volatile accesses have acquire/release semantics (/volatile:ms). */
+#define atomic_load_acquire(p) (*(volatile const int *)(p))
+#define atomic_store_release(p, v) (*(volatile int *)(p) = (v))
+#define refcount_inc(p) InterlockedIncrement(p)
+#define refcount_dec(p) InterlockedDecrement(p)
+#define spin_lock(p) while (InterlockedExchange(p, 1)) {}
+#define spin_unlock(p) InterlockedExchange(p, 0)
+#else
+/* Not thread safe. */
+#define atomic_load_acquire(p) (*(p))
+#define atomic_store_release(p, v) (*(p) = (v))
+#define refcount_inc(p) (++(*(p)))
+#define refcount_dec(p) (--(*(p)))
+#define spin_lock(p) (*(p) = 1)
+#define spin_unlock(p) (*(p) = 0)
+#endif
+
 /* In the following, the arguments should not have side effects.
  * FIXME: Detect in "configure" and check HAVE_* */
 #ifndef strdupa
@@ -465,13 +493,17 @@ typedef struct
 
 dyn_str* dyn_str_new(void);
 void dyn_str_delete(dyn_str*);
+void dyn_str_reserve(dyn_str*, size_t);
 void dyn_strcat(dyn_str*, const char*);
+void dyn_strncat(dyn_str*, const char*, size_t);
 void dyn_trimback(dyn_str*);
 char * dyn_str_take(dyn_str*);
 const char * dyn_str_value(dyn_str*);
 
 size_t altlen(const char **);
 
+void parallel_for(size_t, int, void (*)(size_t, void *), void *);
+
 /* routines for allocating basic objects */
 void init_memusage(void);
 void * xalloc(size_t) GNUC_MALLOC;
@@ -30,6 +30,12 @@ static struct
 	int linkage_limit;
 	int islands_ok;
 	int repeatable_rand;
+	int share_tails;
+	int threads;
+	int result_cache;
+	int lazy_dict;
+	int share_exps;
+	int load_threads;
 	int spell_guess;
 	int short_length;
 	int batch_mode;
@@ -37,10 +43,12 @@ static struct
 	int allow_null;
 	int use_cluster_disjuncts;
 	int use_sat_solver;
+	int sat_eager;
 	int use_viterbi;
 	int echo_on;
 	Cost_Model_type cost_model;
 	double max_cost;
+	int disjunct_budget;
 	int screen_width;
 	int display_on;
 	ConstituentDisplayStyle display_constituents;
@@ -73,12 +81,15 @@ Switch default_switches[] =
 	{"constituents", Int,  "Generate constituent output",   &local.display_constituents},
 	{"cost-model", Int,  UNDOC "Cost model used for ranking", &local.cost_model},
 	{"cost-max",   Float, "Largest cost to be considered",  &local.max_cost},
+	{"disjunct-budget", Int, "Max disjuncts per word",      &local.disjunct_budget},
 	{"disjuncts",  Bool, "Display of disjuncts used",       &local.display_disjuncts},
 	{"echo",       Bool, "Echoing of input sentence",       &local.echo_on},
 	{"graphics",   Bool, "Graphical display of linkage",    &local.display_on},
 	{"islands-ok", Bool, "Use of null-linked islands",      &local.islands_ok},
+	{"lazy-dict",  Bool, "Parse dictionary entries on first use", &local.lazy_dict},
 	{"limit",      Int,  "The maximum linkages processed",  &local.linkage_limit},
 	{"links",      Bool, "Display of complete link data",   &local.display_links},
+	{"load-threads", Int, "Max number of dictionary loading threads", &local.load_threads},
 	{"memory",     Int,  UNDOC "Max memory allowed",        &local.memory},
 	{"morphology", Bool, "Display word morphology",         &local.display_morphology},
 	{"null",       Bool, "Allow null links",                &local.allow_null},
@@ -86,11 +97,18 @@ Switch default_switches[] =
 	{"postscript", Bool, "Generate postscript output",      &local.display_postscript},
 	{"ps-header",  Bool, "Generate postscript header",      &local.display_ps_header},
 	{"rand",       Bool, "Use repeatable random numbers",   &local.repeatable_rand},
+	{"result-cache", Int, "Parse result cache size (KB)",  &local.result_cache},
+#ifdef USE_SAT_SOLVER
+	{"sat-eager",  Bool, "SAT: Encode connectivity in advance", &local.sat_eager},
+#endif /* USE_SAT_SOLVER */
 	{"senses",     Bool, UNDOC "Display of word senses",    &local.display_senses},
+	{"share-exps", Bool, "Share identical dictionary expressions", &local.share_exps},
+	{"share-tails", Bool, "Share identical connector sequences", &local.share_tails},
 	{"short",      Int,  "Max length of short links",       &local.short_length},
 #if defined HAVE_HUNSPELL || defined HAVE_ASPELL
 	{"spell",      Int, "Up to this many spell-guesses per unknown word", &local.spell_guess},
 #endif /* HAVE_HUNSPELL */
+	{"threads",    Int,  "Max number of parsing threads",   &local.threads},
 	{"timeout",    Int,  "Abort parsing after this many seconds", &local.timeout},
 #ifdef USE_SAT_SOLVER
 	{"use-sat",    Bool, "Use Boolean SAT-based parser",    &local.use_sat_solver},
@@ -850,12 +868,20 @@ static void put_opts_in_local_vars(Command_Options* copts)
 	local.linkage_limit = parse_options_get_linkage_limit(opts);
 	local.islands_ok = parse_options_get_islands_ok(opts);
 	local.repeatable_rand = parse_options_get_repeatable_rand(opts);
+	local.share_tails = parse_options_get_share_connector_tails(opts);
+	local.threads = parse_options_get_threads(opts);
+	local.result_cache = parse_options_get_result_cache(opts);
+	local.lazy_dict = dictionary_get_lazy_loading();
+	local.share_exps = dictionary_get_shared_expressions();
+	local.load_threads = dictionary_get_loading_threads();
 	local.spell_guess = parse_options_get_spell_guess(opts);
 	local.short_length = parse_options_get_short_length(opts);
 	local.cost_model = parse_options_get_cost_model_type(opts);
 	local.max_cost = parse_options_get_disjunct_cost(opts);
+	local.disjunct_budget = parse_options_get_disjunct_budget(opts);
 	local.use_cluster_disjuncts = parse_options_get_use_cluster_disjuncts(opts);
 	local.use_sat_solver = parse_options_get_use_sat_parser(opts);
+	local.sat_eager = parse_options_get_sat_eager_constraints(opts);
 #ifdef USE_VITERBI
 	local.use_viterbi = parse_options_get_use_viterbi(opts);
 #endif
@@ -891,13 +917,21 @@ static void put_local_vars_in_opts(Command_Options* copts)
 	parse_options_set_linkage_limit(opts, local.linkage_limit);
 	parse_options_set_islands_ok(opts, local.islands_ok);
 	parse_options_set_repeatable_rand(opts, local.repeatable_rand);
+	parse_options_set_share_connector_tails(opts, local.share_tails);
+	parse_options_set_threads(opts, local.threads);
+	parse_options_set_result_cache(opts, local.result_cache);
+	dictionary_set_lazy_loading(local.lazy_dict);
+	dictionary_set_shared_expressions(local.share_exps);
+	dictionary_set_loading_threads(local.load_threads);
 	parse_options_set_spell_guess(opts, local.spell_guess);
 	parse_options_set_short_length(opts, local.short_length);
 	parse_options_set_cost_model_type(opts, local.cost_model);
 	parse_options_set_disjunct_cost(opts, local.max_cost);
+	parse_options_set_disjunct_budget(opts, local.disjunct_budget);
 	parse_options_set_use_cluster_disjuncts(opts, local.use_cluster_disjuncts);
 #ifdef USE_SAT_SOLVER
 	parse_options_set_use_sat_parser(opts, local.use_sat_solver);
+	parse_options_set_sat_eager_constraints(opts, local.sat_eager);
 #endif
 #ifdef USE_VITERBI
 	parse_options_set_use_viterbi(opts, local.use_viterbi);
@@ -0,0 +1,111 @@
+/***************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                        */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks reloading the dictionary while other threads are parsing,
+// using a Dictionary_handle. The old dictionaries are deleted while
+// sentences that use them may still exist.
+// It also prints the reload latency.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "link-grammar/link-includes.h"
+
+static std::atomic<bool> done(false);
+
+static void parse_sents(Dictionary_handle dh, Parse_Options opts)
+{
+	const char *sents[] = {
+		"It was covered with bites.",
+		"I have no idea what that is.",
+		"We ate popcorn and watched movies on TV for three days.",
+		"The line extends 10 miles offshore.",
+	};
+	int nsents = sizeof(sents) / sizeof(const char *);
+
+	for (int i = 0; !done; i++)
+	{
+		Dictionary dict = dictionary_handle_get(dh);
+		Sentence sent = sentence_create(sents[i%nsents], dict);
+		dictionary_delete(dict); // The sentence holds its own reference.
+
+		if (!sent) {
+			fprintf (stderr, "Fatal error: Unable to create parser\n");
+			exit(2);
+		}
+		sentence_split(sent, opts);
+		int num_linkages = sentence_parse(sent, opts);
+		if (num_linkages <= 0) {
+			fprintf (stderr, "Fatal error: Unable to parse sentence\n");
+			exit(3);
+		}
+		Linkage linkage = linkage_create(0, sent, opts);
+		char * str = linkage_print_diagram(linkage, true, 80);
+		linkage_free_diagram(str);
+		linkage_delete(linkage);
+		sentence_delete(sent);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		fprintf (stderr, "Fatal error: Unable to open the dictionary\n");
+		exit(1);
+	}
+	Dictionary_handle dh = dictionary_handle_create(dict);
+
+	int n_threads = 4;
+	int n_reloads = 5;
+
+	printf("Creating %d threads, reloading the dictionary %d times\n",
+		 n_threads, n_reloads);
+	std::vector<std::thread> thread_pool;
+	for (int i=0; i < n_threads; i++)
+		thread_pool.push_back(std::thread(parse_sents, dh, opts));
+
+	double max_reload = 0, total_reload = 0;
+	for (int i=0; i < n_reloads; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		dict = dictionary_create_lang("en");
+		if (!dict) {
+			fprintf (stderr, "Fatal error: Unable to reopen the dictionary\n");
+			exit(1);
+		}
+		dictionary_handle_set(dh, dict);
+		std::chrono::duration<double> reload =
+			std::chrono::steady_clock::now() - start;
+
+		total_reload += reload.count();
+		if (reload.count() > max_reload) max_reload = reload.count();
+	}
+
+	done = true;
+	for (std::thread& t : thread_pool) t.join();
+	printf("Dictionary reload latency: average %.3f sec, max %.3f sec\n",
+	       total_reload / n_reloads, max_reload);
+
+	dictionary_handle_delete(dh);
+	parse_options_delete(opts);
+	return 0;
+}
@@ -0,0 +1,158 @@
+/***************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                        */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks that the parse results which are copied from the parse
+// result cache (see parse_options_set_result_cache()) are the same as
+// those of parsing the sentences, and that the cache statistics count
+// the lookups and hits. Then the cached sentences are parsed again from
+// several threads at once, which all use the cache of the same
+// dictionary. Each of them uses its own Parse_Options, since the parser
+// modifies them while parsing.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "link-grammar/link-includes.h"
+
+static const char *sents[] = {
+	"this is a test",
+	"about people attended",
+	"this this is is a a test",
+	"The man who the dog that the cat chased bit went to the store.",
+	"Frank felt vindicated when his long time friend Bill revealed that he was the winner of the competition.",
+	"His shout had been involuntary, something anybody might have done.",
+};
+
+static const int nsents = sizeof(sents) / sizeof(const char *);
+
+// The parse results of the given sentence: The null count, the number
+// of linkages, and the diagrams of the linkages in their order.
+static std::string parse_results(Dictionary dict, Parse_Options opts,
+                                 const char *sent_str)
+{
+	Sentence sent = sentence_create(sent_str, dict);
+	if (!sent) {
+		fprintf (stderr, "Fatal error: Unable to create parser\n");
+		exit(2);
+	}
+	sentence_split(sent, opts);
+	int num_linkages = sentence_parse(sent, opts);
+	if (num_linkages <= 0) {
+		fprintf (stderr, "Fatal error: Unable to parse \"%s\"\n", sent_str);
+		exit(3);
+	}
+
+	std::string results = std::to_string(sentence_null_count(sent)) + " " +
+		std::to_string(sentence_num_linkages_found(sent)) + " " +
+		std::to_string(num_linkages) + "\n";
+	for (int li = 0; li < num_linkages; li++)
+	{
+		Linkage linkage = linkage_create(li, sent, opts);
+		char * str = linkage_print_diagram(linkage, true, 80);
+		results += str;
+		linkage_free_diagram(str);
+		linkage_delete(linkage);
+	}
+	sentence_delete(sent);
+
+	return results;
+}
+
+static Parse_Options create_opts(int result_cache)
+{
+	Parse_Options opts = parse_options_create();
+	parse_options_set_verbosity(opts, 0);
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_max_null_count(opts, 20);
+	parse_options_set_result_cache(opts, result_cache);
+	return opts;
+}
+
+static void check_stats(Dictionary dict, size_t lookups, size_t hits)
+{
+	lg_parse_cache_stats stats;
+
+	dictionary_get_parse_cache_stats(dict, &stats);
+	if ((stats.lookups != lookups) || (stats.hits != hits) ||
+	    (stats.num_entries != (size_t)nsents) || (stats.evictions != 0))
+	{
+		fprintf (stderr, "Fatal error: Parse cache statistics: "
+		         "%zu lookups (expected %zu), %zu hits (expected %zu), "
+		         "%zu entries (expected %d), %zu evictions\n",
+		         stats.lookups, lookups, stats.hits, hits,
+		         stats.num_entries, nsents, stats.evictions);
+		exit(5);
+	}
+}
+
+static void check_sents(Dictionary dict, const std::vector<std::string> *expected,
+                        int niter)
+{
+	Parse_Options opts = create_opts(1024);
+
+	for (int j = 0; j < niter; j++)
+	{
+		for (int i = 0; i < nsents; i++)
+		{
+			if (parse_results(dict, opts, sents[i]) != (*expected)[i])
+			{
+				fprintf (stderr, "Fatal error: Different results from the "
+				         "cache for \"%s\"\n", sents[i]);
+				exit(4);
+			}
+		}
+	}
+
+	parse_options_delete(opts);
+}
+
+int main(int argc, char* argv[])
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		fprintf (stderr, "Fatal error: Unable to open the dictionary\n");
+		exit(1);
+	}
+
+	std::vector<std::string> expected;
+	Parse_Options opts = create_opts(0);
+	for (int i = 0; i < nsents; i++)
+		expected.push_back(parse_results(dict, opts, sents[i]));
+	parse_options_delete(opts);
+
+	// The first parse of each sentence is a miss, the second one a hit.
+	check_sents(dict, &expected, 2);
+	check_stats(dict, 2*nsents, nsents);
+
+	int n_threads = 3;
+	int niter = 3;
+
+	printf("Creating %d threads, each comparing %d times the cached parses "
+	       "of %d sentences\n", n_threads, niter, nsents);
+	std::vector<std::thread> thread_pool;
+	for (int i=0; i < n_threads; i++)
+		thread_pool.push_back(std::thread(check_sents, dict, &expected, niter));
+
+	for (std::thread& t : thread_pool) t.join();
+	printf("Done with parsing with threads\n");
+
+	size_t lookups = (2 + n_threads*niter) * nsents;
+	check_stats(dict, lookups, lookups - nsents);
+
+	dictionary_delete(dict);
+	return 0;
+}
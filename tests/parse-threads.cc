@@ -0,0 +1,132 @@
+/***************************************************************************/
+/* Copyright (c) 2018 Linas Vepstas                                        */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks that parsing a sentence with several threads (see
+// parse_options_set_threads()) gives the same results as parsing it
+// in a single thread. Most of the sentences have no complete linkage,
+// so several null counts are counted concurrently. The check is done
+// from several application threads at once. Each of them uses its own
+// Parse_Options, since the parser modifies them while parsing.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "link-grammar/link-includes.h"
+
+static const char *sents[] = {
+	"about people attended",
+	"this this is is a a test",
+	"about people attended the the meeting of of which we we spoke",
+	"the the the dog dog ran ran quickly to to the house house",
+	"Frank felt vindicated when his long time friend Bill revealed that he was the winner of the competition.",
+	"His shout had been involuntary, something anybody might have done.",
+};
+
+// The parse results of the given sentence: The null count, the number
+// of linkages, and the diagrams of the linkages in their order.
+static std::string parse_results(Dictionary dict, Parse_Options opts,
+                                 const char *sent_str)
+{
+	Sentence sent = sentence_create(sent_str, dict);
+	if (!sent) {
+		fprintf (stderr, "Fatal error: Unable to create parser\n");
+		exit(2);
+	}
+	sentence_split(sent, opts);
+	int num_linkages = sentence_parse(sent, opts);
+	if (num_linkages <= 0) {
+		fprintf (stderr, "Fatal error: Unable to parse \"%s\"\n", sent_str);
+		exit(3);
+	}
+
+	std::string results = std::to_string(sentence_null_count(sent)) + " " +
+		std::to_string(sentence_num_linkages_found(sent)) + " " +
+		std::to_string(num_linkages) + "\n";
+	for (int li = 0; li < num_linkages; li++)
+	{
+		Linkage linkage = linkage_create(li, sent, opts);
+		char * str = linkage_print_diagram(linkage, true, 80);
+		results += str;
+		linkage_free_diagram(str);
+		linkage_delete(linkage);
+	}
+	sentence_delete(sent);
+
+	return results;
+}
+
+static Parse_Options create_opts(int threads)
+{
+	Parse_Options opts = parse_options_create();
+	parse_options_set_verbosity(opts, 0);
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_max_null_count(opts, 20);
+	parse_options_set_threads(opts, threads);
+	if (threads != parse_options_get_threads(opts)) {
+		fprintf (stderr, "Fatal error: Unable to set the number of threads\n");
+		exit(1);
+	}
+	return opts;
+}
+
+static void check_sents(Dictionary dict, int niter)
+{
+	int nsents = sizeof(sents) / sizeof(const char *);
+	Parse_Options single = create_opts(1);
+	Parse_Options multi = create_opts(4);
+
+	for (int j = 0; j < niter; j++)
+	{
+		for (int i = 0; i < nsents; i++)
+		{
+			if (parse_results(dict, single, sents[i]) !=
+			    parse_results(dict, multi, sents[i]))
+			{
+				fprintf (stderr, "Fatal error: Different results with "
+				         "threads for \"%s\"\n", sents[i]);
+				exit(4);
+			}
+		}
+	}
+
+	parse_options_delete(single);
+	parse_options_delete(multi);
+}
+
+int main(int argc, char* argv[])
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		fprintf (stderr, "Fatal error: Unable to open the dictionary\n");
+		exit(1);
+	}
+
+	int n_threads = 3;
+	int niter = 3;
+
+	printf("Creating %d threads, each comparing %d times the parses of "
+	       "%zu sentences\n", n_threads, niter, sizeof(sents)/sizeof(char *));
+	std::vector<std::thread> thread_pool;
+	for (int i=0; i < n_threads; i++)
+		thread_pool.push_back(std::thread(check_sents, dict, niter));
+
+	for (std::thread& t : thread_pool) t.join();
+	printf("Done with parsing with threads\n");
+
+	dictionary_delete(dict);
+	return 0;
+}